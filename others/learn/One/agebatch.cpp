@@ -0,0 +1,63 @@
+#include "agebatch.h"
+#include "agecalc.h"
+#include "ageindex.h"
+#include <cstring>
+
+int AgeBatch::size() const
+{
+    return ages.size();
+}
+
+QByteArray AgeBatch::nameUtf8(int index) const
+{
+    const qint64 start = index ? nameEnds.at(index - 1) : 0;
+    return names.mid(qsizetype(start), qsizetype(nameEnds.at(index) - start));
+}
+
+QString AgeBatch::name(int index) const
+{
+    const qint64 start = index ? nameEnds.at(index - 1) : 0;
+    return QString::fromUtf8(names.constData() + start, qsizetype(nameEnds.at(index) - start));
+}
+
+void AgeBatch::append(const AgeBatch &other)
+{
+    const qint64 base = names.size();
+    names.append(other.names);
+    nameEnds.reserve(nameEnds.size() + other.nameEnds.size());
+    for (qint64 end : other.nameEnds) nameEnds.append(base + end);
+    ages.append(other.ages);
+
+    if (!firstRejectedLine && other.firstRejectedLine) firstRejectedLine = lines + other.firstRejectedLine;
+    lines += other.lines;
+    rejected += other.rejected;
+}
+
+void AgeBatch::clear()
+{
+    *this = AgeBatch();
+}
+
+int AgeBatch::toAgeCalcs(QObject *parent, AgeIndex *index) const
+{
+    // Equal names next to each other share one QString
+    QString last;
+    qint64 lastStart = -1;
+    qint64 lastEnd = -1;
+    for (int i = 0; i < size(); i++) {
+        const qint64 start = i ? nameEnds.at(i - 1) : 0;
+        const qint64 end = nameEnds.at(i);
+        if (lastStart < 0 || end - start != lastEnd - lastStart
+            || memcmp(names.constData() + start, names.constData() + lastStart, size_t(end - start)) != 0) {
+            last = QString::fromUtf8(names.constData() + start, qsizetype(end - start));
+            lastStart = start;
+            lastEnd = end;
+        }
+
+        AgeCalc *calc = new AgeCalc(parent);
+        calc->setName(last);
+        calc->setAge(ages.at(i));
+        if (index) index->add(calc);
+    }
+    return size();
+}
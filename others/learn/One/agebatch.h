@@ -0,0 +1,35 @@
+#ifndef AGEBATCH_H
+#define AGEBATCH_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+class QObject;
+class AgeIndex;
+
+// Column-wise name/age records, as filled by CsvImporter. Names stay UTF-8 and sit
+// back to back in one buffer; name i ends where nameEnds[i] says. Offsets stay 64-bit
+// all the way through; under Qt 5 QByteArray itself holds a batch to 2 GB of names.
+struct AgeBatch
+{
+    QByteArray names;
+    QVector<qint64> nameEnds;
+    QVector<qint32> ages;
+
+    qint64 lines = 0;
+    qint64 rejected = 0;
+    qint64 firstRejectedLine = 0; // 1-based, 0 when nothing was rejected
+
+    int size() const;
+    QByteArray nameUtf8(int index) const;
+    QString name(int index) const;
+
+    void append(const AgeBatch &other);
+    void clear();
+
+    // One AgeCalc per record under parent, optionally added to index
+    int toAgeCalcs(QObject *parent, AgeIndex *index = nullptr) const;
+};
+
+#endif // AGEBATCH_H
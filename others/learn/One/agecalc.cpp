@@ -1,9 +1,16 @@
 #include "agecalc.h"
+#include "speciesregistry.h"
+#include "ageindex.h"
 
 AgeCalc::AgeCalc(QObject *parent)
     : QObject{parent}
 {}
 
+AgeCalc::~AgeCalc()
+{
+    if (m_index) m_index->remove(this);
+}
+
 int AgeCalc::age() const
 {
     return m_age;
@@ -12,6 +19,7 @@ int AgeCalc::age() const
 void AgeCalc::setAge(int newAge)
 {
     m_age = newAge;
+    if (m_index) m_index->ageChanged(this);
 }
 
 QString AgeCalc::name() const
@@ -22,16 +30,21 @@ QString AgeCalc::name() const
 void AgeCalc::setName(const QString &newName)
 {
     m_name = newName;
+    if (m_index) m_index->nameChanged(this);
 }
 
+// The tables only cover valid ages; anything else keeps the plain multiplication
+// these getters always did
 int AgeCalc::dogYears() const
 {
-    return m_age * 7;
+    if (!SpeciesRegistry::isValidAge(m_age)) return m_age * SpeciesRegistry::Factor<Canine>::value;
+    return SpeciesRegistry::years<Canine>(m_age);
 }
 
 int AgeCalc::catYears() const
 {
-    return m_age * 9;
+    if (!SpeciesRegistry::isValidAge(m_age)) return m_age * SpeciesRegistry::Factor<Feline>::value;
+    return SpeciesRegistry::years<Feline>(m_age);
 }
 
 int AgeCalc::humanYears() const
@@ -3,11 +3,14 @@
 
 #include <QObject>
 
+class AgeIndex;
+
 class AgeCalc : public QObject
 {
     Q_OBJECT
 public:
     explicit AgeCalc(QObject *parent = nullptr);
+    ~AgeCalc();
 
     int age() const;
     void setAge(int newAge);
@@ -22,8 +25,12 @@ public:
 signals:
 
 private:
-    int m_age;
+    friend class AgeIndex;
+
+    int m_age = 0;
     QString m_name;
+    AgeIndex *m_index = nullptr; // Told about every change, see AgeIndex
+    int m_indexSlot = -1;
 };
 
 #endif // AGECALC_H
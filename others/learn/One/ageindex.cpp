@@ -0,0 +1,170 @@
+#include "ageindex.h"
+#include "agecalc.h"
+
+AgeIndex::~AgeIndex()
+{
+    clear();
+}
+
+void AgeIndex::add(AgeCalc *calc)
+{
+    if (calc->m_index == this) return;
+    if (calc->m_index) calc->m_index->remove(calc);
+
+    int slot;
+    if (m_free.empty()) {
+        slot = int(m_entries.size());
+        m_entries.push_back({});
+    } else {
+        slot = m_free.back();
+        m_free.pop_back();
+    }
+
+    Entry &entry = m_entries[size_t(slot)];
+    entry.calc = calc;
+    entry.age = bucketOf(calc->m_age);
+    entry.name = intern(calc->m_name);
+    link(slot);
+
+    calc->m_index = this;
+    calc->m_indexSlot = slot;
+    m_size++;
+}
+
+void AgeIndex::remove(AgeCalc *calc)
+{
+    if (calc->m_index != this) return;
+
+    const int slot = calc->m_indexSlot;
+    unlink(slot);
+    m_entries[size_t(slot)].calc = nullptr;
+    m_free.push_back(slot);
+
+    calc->m_index = nullptr;
+    calc->m_indexSlot = -1;
+    m_size--;
+}
+
+void AgeIndex::clear()
+{
+    for (Entry &entry : m_entries) {
+        if (!entry.calc) continue;
+        entry.calc->m_index = nullptr;
+        entry.calc->m_indexSlot = -1;
+    }
+    m_entries.clear();
+    m_free.clear();
+    for (std::vector<int> &bucket : m_buckets) bucket.clear();
+    m_nameIds.clear();
+    m_names.clear();
+    m_size = 0;
+}
+
+int AgeIndex::size() const
+{
+    return m_size;
+}
+
+QVector<AgeCalc *> AgeIndex::aged(int from, int to) const
+{
+    QVector<AgeCalc *> found;
+    forEachAged(from, to, [&found](AgeCalc *calc) { found.append(calc); });
+    return found;
+}
+
+QVector<AgeCalc *> AgeIndex::named(const QString &name) const
+{
+    QVector<AgeCalc *> found;
+    const int id = m_nameIds.value(name, -1);
+    if (id < 0) return found;
+
+    const std::vector<int> &slots = m_names[size_t(id)];
+    found.reserve(int(slots.size()));
+    for (int slot : slots) found.append(m_entries[size_t(slot)].calc);
+    return found;
+}
+
+AgeCalc *AgeIndex::find(const QString &name) const
+{
+    const int id = m_nameIds.value(name, -1);
+    if (id < 0 || m_names[size_t(id)].empty()) return nullptr;
+    return m_entries[size_t(m_names[size_t(id)].front())].calc;
+}
+
+int AgeIndex::countNamed(const QString &name) const
+{
+    const int id = m_nameIds.value(name, -1);
+    return id < 0 ? 0 : int(m_names[size_t(id)].size());
+}
+
+int AgeIndex::bucketOf(int age)
+{
+    return SpeciesRegistry::isValidAge(age) ? age : 0;
+}
+
+int AgeIndex::intern(const QString &name)
+{
+    auto it = m_nameIds.constFind(name);
+    if (it != m_nameIds.cend()) return it.value();
+
+    // Names stay interned after their last holder leaves; populations reuse them
+    const int id = int(m_names.size());
+    m_names.emplace_back();
+    m_nameIds.insert(name, id);
+    return id;
+}
+
+void AgeIndex::link(int slot)
+{
+    Entry &entry = m_entries[size_t(slot)];
+
+    std::vector<int> &bucket = m_buckets[size_t(entry.age)];
+    entry.agePosition = int(bucket.size());
+    bucket.push_back(slot);
+
+    std::vector<int> &holders = m_names[size_t(entry.name)];
+    entry.namePosition = int(holders.size());
+    holders.push_back(slot);
+}
+
+void AgeIndex::unlink(int slot)
+{
+    const Entry &entry = m_entries[size_t(slot)];
+
+    // Swap with the last one so removal stays O(1)
+    std::vector<int> &bucket = m_buckets[size_t(entry.age)];
+    const int movedAge = bucket.back();
+    bucket[size_t(entry.agePosition)] = movedAge;
+    m_entries[size_t(movedAge)].agePosition = entry.agePosition;
+    bucket.pop_back();
+
+    std::vector<int> &holders = m_names[size_t(entry.name)];
+    const int movedName = holders.back();
+    holders[size_t(entry.namePosition)] = movedName;
+    m_entries[size_t(movedName)].namePosition = entry.namePosition;
+    holders.pop_back();
+}
+
+void AgeIndex::ageChanged(AgeCalc *calc)
+{
+    const int slot = calc->m_indexSlot;
+    const int age = bucketOf(calc->m_age);
+    Entry &entry = m_entries[size_t(slot)];
+    if (entry.age == age) return;
+
+    unlink(slot);
+    entry.age = age;
+    link(slot);
+}
+
+void AgeIndex::nameChanged(AgeCalc *calc)
+{
+    const int slot = calc->m_indexSlot;
+    const int name = intern(calc->m_name);
+    Entry &entry = m_entries[size_t(slot)];
+    if (entry.name == name) return;
+
+    unlink(slot);
+    entry.name = name;
+    link(slot);
+}
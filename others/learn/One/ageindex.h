@@ -0,0 +1,90 @@
+#ifndef AGEINDEX_H
+#define AGEINDEX_H
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+#include <vector>
+#include "speciesregistry.h"
+
+class AgeCalc;
+
+// Answers "which calculators are aged between x and y" and "which are named n"
+// without scanning. Ages are bounded, so every age has its own bucket
+// (counting-sort style) and a range query walks at most 120 buckets plus its
+// output. Names are interned once; each distinct name keeps its own list.
+// AgeCalc::setAge/setName keep the index current, and destroyed calculators
+// leave it on their own. A calculator belongs to at most one index. Use it from
+// the thread that owns the calculators.
+class AgeIndex
+{
+public:
+    AgeIndex() = default;
+    AgeIndex(const AgeIndex &) = delete;
+    AgeIndex &operator=(const AgeIndex &) = delete;
+    ~AgeIndex();
+
+    void add(AgeCalc *calc);
+    void remove(AgeCalc *calc);
+    void clear();
+    int size() const;
+
+    // Ages in human years, both ends included
+    template <typename Visitor>
+    void forEachAged(int from, int to, Visitor &&visit) const {
+        from = qMax(from, SpeciesRegistry::MinAge);
+        to = qMin(to, SpeciesRegistry::MaxAge);
+        for (int age = from; age <= to; age++) {
+            for (int slot : m_buckets[size_t(age)]) visit(m_entries[size_t(slot)].calc);
+        }
+    }
+
+    // Ages in the years of a built-in species, e.g. forEachInYears<Canine>(100, 200, ...)
+    template <typename Species, typename Visitor>
+    void forEachInYears(int from, int to, Visitor &&visit) const {
+        for (int age = SpeciesRegistry::MinAge; age <= SpeciesRegistry::MaxAge; age++) {
+            const int years = SpeciesRegistry::table<Species>[size_t(age)];
+            if (years < from || years > to) continue;
+            for (int slot : m_buckets[size_t(age)]) visit(m_entries[size_t(slot)].calc);
+        }
+    }
+
+    QVector<AgeCalc *> aged(int from, int to) const;
+    template <typename Species>
+    QVector<AgeCalc *> inYears(int from, int to) const {
+        QVector<AgeCalc *> found;
+        forEachInYears<Species>(from, to, [&found](AgeCalc *calc) { found.append(calc); });
+        return found;
+    }
+
+    QVector<AgeCalc *> named(const QString &name) const;
+    AgeCalc *find(const QString &name) const;
+    int countNamed(const QString &name) const;
+
+private:
+    friend class AgeCalc;
+
+    struct Entry {
+        AgeCalc *calc;
+        int age;
+        int agePosition;
+        int name;
+        int namePosition;
+    };
+
+    static int bucketOf(int age);
+    int intern(const QString &name);
+    void link(int slot);
+    void unlink(int slot);
+    void ageChanged(AgeCalc *calc);
+    void nameChanged(AgeCalc *calc);
+
+    std::vector<Entry> m_entries;
+    std::vector<int> m_free;
+    std::vector<int> m_buckets[SpeciesRegistry::MaxAge + 1]; // Bucket 0 holds unset or invalid ages
+    QHash<QString, int> m_nameIds;
+    std::vector<std::vector<int>> m_names;
+    int m_size = 0;
+};
+
+#endif // AGEINDEX_H
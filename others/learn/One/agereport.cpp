@@ -0,0 +1,171 @@
+#include "agereport.h"
+#include <QDebug>
+#include <QFile>
+#include <QThread>
+#include <vector>
+#include "agecalc.h"
+
+#ifdef Q_OS_UNIX
+#include <cerrno>
+#include <climits>
+#include <sys/uio.h>
+#include <unistd.h>
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+#endif
+
+namespace {
+
+void appendNumber(QByteArray &out, int value)
+{
+    char digits[12];
+    char *p = digits + sizeof digits;
+    unsigned magnitude = value < 0 ? 0u - unsigned(value) : unsigned(value);
+    do {
+        *--p = char('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude);
+    if (value < 0) *--p = '-';
+    out.append(p, int(digits + sizeof digits - p));
+}
+
+// Printable ASCII other than quote and backslash comes out of QDebug unchanged
+bool isPlain(const QString &text)
+{
+    for (QChar ch : text) {
+        const ushort unit = ch.unicode();
+        if (unit < 0x20 || unit > 0x7E || unit == '"' || unit == '\\') return false;
+    }
+    return true;
+}
+
+void appendQuoted(QByteArray &out, const QString &text)
+{
+    if (isPlain(text)) {
+        out.append('"');
+        for (QChar ch : text) out.append(char(ch.unicode()));
+        out.append('"');
+        return;
+    }
+
+    // Leave escaping to QDebug itself so the rare cases stay identical too
+    QString quoted;
+    QDebug(&quoted) << text;
+    if (quoted.endsWith(' ')) quoted.chop(1);
+    out.append(quoted.toUtf8());
+}
+
+} // namespace
+
+AgeReport::AgeReport(int threads)
+    : m_threads(threads > 0 ? threads : qMax(1, QThread::idealThreadCount()))
+{}
+
+void AgeReport::appendPerson(QByteArray &out, const QString &name, int human, int dog, int cat)
+{
+    // qInfo() puts a space between items, and the labels end in one of their own
+    const int start = out.size();
+    appendQuoted(out, name);
+    const int quotedLength = out.size() - start;
+
+    // The name is copied from out into out, so it must not move while we do that
+    const int needed = 2 * quotedLength + 3 * 28;
+    if (out.capacity() - out.size() < needed) out.reserve(qMax(out.size() + needed, out.capacity() * 2));
+
+    out.append(" Human Years:  ");
+    appendNumber(out, human);
+    out.append('\n');
+
+    out.append(out.constData() + start, quotedLength);
+    out.append(" Dog Years:  ");
+    appendNumber(out, dog);
+    out.append('\n');
+
+    out.append(out.constData() + start, quotedLength);
+    out.append(" Cat Years:  ");
+    appendNumber(out, cat);
+    out.append('\n');
+}
+
+QList<QByteArray> AgeReport::format(const QList<AgeCalc *> &people) const
+{
+    const int chunks = qMax(1, qMin(m_threads, people.size() / 1024));
+    std::vector<QByteArray> buffers(size_t(chunks), QByteArray());
+
+    auto formatChunk = [&people, &buffers, chunks](int chunk) {
+        const int begin = int(qint64(people.size()) * chunk / chunks);
+        const int end = int(qint64(people.size()) * (chunk + 1) / chunks);
+        QByteArray &out = buffers[size_t(chunk)];
+        out.reserve((end - begin) * 96);
+        for (int i = begin; i < end; i++) {
+            const AgeCalc *calc = people.at(i);
+            appendPerson(out, calc->name(), calc->humanYears(), calc->dogYears(), calc->catYears());
+        }
+    };
+
+    std::vector<QThread *> threads;
+    for (int chunk = 1; chunk < chunks; chunk++) {
+        threads.push_back(QThread::create(formatChunk, chunk));
+        threads.back()->start();
+    }
+    formatChunk(0);
+    for (QThread *thread : threads) {
+        thread->wait();
+        delete thread;
+    }
+
+    QList<QByteArray> parts;
+    for (QByteArray &buffer : buffers) parts.append(std::move(buffer));
+    return parts;
+}
+
+QByteArray AgeReport::generate(const QList<AgeCalc *> &people) const
+{
+    const QList<QByteArray> parts = format(people);
+    qint64 total = 0;
+    for (const QByteArray &part : parts) total += part.size();
+
+    QByteArray report;
+    report.reserve(int(total));
+    for (const QByteArray &part : parts) report.append(part);
+    return report;
+}
+
+bool AgeReport::write(const QList<AgeCalc *> &people, int fd) const
+{
+    const QList<QByteArray> parts = format(people);
+#ifdef Q_OS_UNIX
+    std::vector<iovec> vectors;
+    for (const QByteArray &part : parts) {
+        if (!part.isEmpty()) vectors.push_back({const_cast<char *>(part.constData()), size_t(part.size())});
+    }
+
+    size_t next = 0;
+    while (next < vectors.size()) {
+        const int count = int(qMin<size_t>(IOV_MAX, vectors.size() - next));
+        ssize_t written = ::writev(fd, vectors.data() + next, count);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        // Short writes: skip what went out and go again
+        while (written > 0 && next < vectors.size()) {
+            iovec &vector = vectors[next];
+            const size_t step = qMin<size_t>(size_t(written), vector.iov_len);
+            vector.iov_base = static_cast<char *>(vector.iov_base) + step;
+            vector.iov_len -= step;
+            written -= ssize_t(step);
+            if (vector.iov_len == 0) next++;
+        }
+    }
+    return true;
+#else
+    QFile out;
+    if (!out.open(fd, QIODevice::WriteOnly)) return false;
+    for (const QByteArray &part : parts) {
+        if (out.write(part) != part.size()) return false;
+    }
+    return out.flush();
+#endif
+}
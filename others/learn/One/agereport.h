@@ -0,0 +1,30 @@
+#ifndef AGEREPORT_H
+#define AGEREPORT_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+class AgeCalc;
+
+// The same three lines per person that printAges() logs, built without QDebug:
+// rows are formatted in parallel into one buffer per thread, and the buffers go
+// out in the original order with a single writev(). The text is byte-identical to
+// the messages printAges() produces, one per line.
+class AgeReport
+{
+public:
+    explicit AgeReport(int threads = 0); // 0 means QThread::idealThreadCount()
+
+    QList<QByteArray> format(const QList<AgeCalc *> &people) const;
+    QByteArray generate(const QList<AgeCalc *> &people) const;
+    bool write(const QList<AgeCalc *> &people, int fd = 2) const;
+
+    // QDebug's quoting of name followed by the three lines for one person
+    static void appendPerson(QByteArray &out, const QString &name, int human, int dog, int cat);
+
+private:
+    int m_threads;
+};
+
+#endif // AGEREPORT_H
@@ -1,19 +1,31 @@
 #include "animal.h"
+#include "teardown.h"
 
 Animal::Animal(QObject *parent)
     : QObject{parent}
 {
     count++;
-    qInfo() << this << "Constructed";
+    if (!quiet) qInfo() << this << "Constructed";
 }
 
 Animal::~Animal()
 {
     count--;
-    qInfo() << this << "Deconstructed";
+    if (!quiet) qInfo() << this << "Deconstructed";
 }
 
 void Animal::speak(QString message)
 {
     qInfo() << this << message;
 }
+
+int Animal::teardown(QObject *parent)
+{
+    const int before = count;
+    const bool wasQuiet = quiet;
+    quiet = true;
+    int deleted = Teardown::children(parent);
+    quiet = wasQuiet;
+    if (!quiet) qInfo() << parent << "Deconstructed" << before - count << "animals";
+    return deleted;
+}
@@ -3,6 +3,7 @@
 
 #include <QObject>
 #include <QDebug>
+#include <atomic>
 
 class Animal : public QObject
 {
@@ -11,9 +12,44 @@ public:
     explicit Animal(QObject *parent = nullptr);
     ~Animal();
 
+    // Preorder numbering of the hierarchy, so a class and all of its subclasses
+    // form one contiguous range. Every class declares its own TypeFirst/TypeLast;
+    // a new subclass takes the next id and widens the ranges of its ancestors.
+    enum Type : quint8 {
+        AnimalType,
+        MammalType,
+        CanineType,
+        FelineType,
+        TypeCount
+    };
+    static constexpr quint8 TypeFirst = AnimalType;
+    static constexpr quint8 TypeLast = TypeCount - 1;
+
+    Type type() const {
+        return Type(m_type);
+    }
+
+    // "Is this a T" in one unsigned compare, without walking the metaobjects
+    template <typename T>
+    bool is() const {
+        return quint8(m_type - T::TypeFirst) <= quint8(T::TypeLast - T::TypeFirst);
+    }
+
+    template <typename T>
+    T *as() {
+        return is<T>() ? static_cast<T *>(this) : nullptr;
+    }
+
     QString name;
     static int count;
 
+    // Silences the per-object lifetime messages of the whole hierarchy. Read by
+    // whichever thread creates or deletes an animal, so it is atomic.
+    static std::atomic<bool> quiet;
+
+    // Deletes all children of parent in linear time with one summary line
+    static int teardown(QObject *parent);
+
     void speak(QString message);
 
     bool isAlive() {
@@ -21,6 +57,9 @@ public:
     }
 
 signals:
+
+protected:
+    quint8 m_type = AnimalType; // Each constructor in the chain overwrites it
 };
 
 #endif // ANIMAL_H
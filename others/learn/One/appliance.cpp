@@ -1,8 +1,13 @@
 #include "appliance.h"
+#include "applianceinterfaces.h"
 
 Appliance::Appliance(QObject *parent)
     : QObject{parent}
 {
+    // Once, before the first appliance can be looked up
+    static const bool registered = ApplianceInterfaces::registerType<Appliance>();
+    Q_UNUSED(registered);
+
     qInfo() << this << "Constructed";
 }
 
@@ -0,0 +1,91 @@
+#include "applianceinterfaces.h"
+#include <QMutex>
+#include <atomic>
+
+namespace {
+
+// Open addressing on the metaobject address. Slots are only ever filled, never
+// cleared, so readers can probe without locking.
+constexpr int Slots = 64;
+
+struct Slot {
+    std::atomic<const QMetaObject *> type{nullptr};
+    std::atomic<const ApplianceInterfaces::Table *> table{nullptr};
+};
+
+Slot entries[Slots];
+QMutex mutex;
+int used = 0;
+
+inline int home(const QMetaObject *type)
+{
+    return int((quintptr(type) >> 4) * 0x9E3779B97F4A7C15ULL >> 58); // Top 6 bits: 0..63
+}
+
+} // namespace
+
+bool ApplianceInterfaces::add(const QMetaObject *type, const Table *table)
+{
+    QMutexLocker locker(&mutex);
+    for (int probe = 0, i = home(type); probe < Slots; probe++, i = (i + 1) % Slots) {
+        const QMetaObject *current = entries[i].type.load(std::memory_order_relaxed);
+        if (current == type) return true;
+        if (current) continue;
+        if (used + 1 >= Slots) break; // Keep one empty slot so misses terminate
+
+        // Table first, so a reader that sees the type also sees its table
+        entries[i].table.store(table, std::memory_order_relaxed);
+        entries[i].type.store(type, std::memory_order_release);
+        used++;
+        return true;
+    }
+    qWarning("ApplianceInterfaces: no room for %s", type->className());
+    return false;
+}
+
+const ApplianceInterfaces::Table *ApplianceInterfaces::find(const QMetaObject *type)
+{
+    for (int i = home(type);; i = (i + 1) % Slots) {
+        const QMetaObject *current = entries[i].type.load(std::memory_order_acquire);
+        if (current == type) return entries[i].table.load(std::memory_order_relaxed);
+        if (!current) return nullptr;
+    }
+}
+
+const ApplianceInterfaces::Table *ApplianceInterfaces::table(const QObject *object)
+{
+    if (!object) return nullptr;
+    for (const QMetaObject *type = object->metaObject(); type; type = type->superClass()) {
+        if (const Table *found = find(type)) return found;
+    }
+    return nullptr;
+}
+
+quint8 ApplianceInterfaces::capabilities(const QObject *object)
+{
+    const Table *found = table(object);
+    return found ? found->capabilities : 0;
+}
+
+bool ApplianceInterfaces::can(const QObject *object, Capability capability)
+{
+    return capabilities(object) & capability;
+}
+
+Freezer *ApplianceInterfaces::freezer(QObject *object)
+{
+    const Table *found = table(object);
+    return found ? found->freezer(object) : nullptr;
+}
+
+Toaster *ApplianceInterfaces::toaster(QObject *object)
+{
+    const Table *found = table(object);
+    return found ? found->toaster(object) : nullptr;
+}
+
+Microwave *ApplianceInterfaces::microwave(QObject *object)
+{
+    const Table *found = table(object);
+    return found ? found->microwave(object) : nullptr;
+}
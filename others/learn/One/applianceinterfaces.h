@@ -0,0 +1,73 @@
+#ifndef APPLIANCEINTERFACES_H
+#define APPLIANCEINTERFACES_H
+
+#include <QObject>
+#include <type_traits>
+#include "Freezer.h"
+#include "Microwave.h"
+#include "Toaster.h"
+
+// Reaching Freezer/Toaster/Microwave from a plain QObject* normally takes a
+// dynamic_cast across the multiple-inheritance layout. Instead, every registered
+// type gets a capability mask, fixed at compile time, and a table of static_cast
+// thunks. Both are found by the object's QMetaObject, so a check is one virtual
+// call and a probe of a small table, and fetching an interface is one more call.
+// Register types before looking them up; registration is thread-safe, lookups
+// take no lock.
+class ApplianceInterfaces
+{
+public:
+    enum Capability : quint8 {
+        CanFreeze = 1,
+        CanGrill = 2,
+        CanCook = 4
+    };
+
+    struct Table {
+        quint8 capabilities;
+        Freezer *(*freezer)(QObject *);
+        Toaster *(*toaster)(QObject *);
+        Microwave *(*microwave)(QObject *);
+    };
+
+    template <typename T>
+    static constexpr quint8 capabilitiesOf() {
+        return (std::is_base_of_v<Freezer, T> ? CanFreeze : 0)
+               | (std::is_base_of_v<Toaster, T> ? CanGrill : 0)
+               | (std::is_base_of_v<Microwave, T> ? CanCook : 0);
+    }
+
+    template <typename T>
+    static bool registerType() {
+        static const Table table = {
+            capabilitiesOf<T>(),
+            [](QObject *object) -> Freezer * { return cast<T, Freezer>(object); },
+            [](QObject *object) -> Toaster * { return cast<T, Toaster>(object); },
+            [](QObject *object) -> Microwave * { return cast<T, Microwave>(object); },
+        };
+        return add(&T::staticMetaObject, &table);
+    }
+
+    // Subclasses of a registered type that did not register themselves are found
+    // through their superclass chain, which is slower but still RTTI-free
+    static const Table *table(const QObject *object);
+
+    static quint8 capabilities(const QObject *object);
+    static bool can(const QObject *object, Capability capability);
+
+    static Freezer *freezer(QObject *object);
+    static Toaster *toaster(QObject *object);
+    static Microwave *microwave(QObject *object);
+
+private:
+    template <typename T, typename Interface>
+    static Interface *cast(QObject *object) {
+        if constexpr (std::is_base_of_v<Interface, T>) return static_cast<Interface *>(static_cast<T *>(object));
+        else return nullptr;
+    }
+
+    static bool add(const QMetaObject *type, const Table *table);
+    static const Table *find(const QMetaObject *type);
+};
+
+#endif // APPLIANCEINTERFACES_H
@@ -0,0 +1,139 @@
+#include "appliancequeue.h"
+
+#ifdef Q_OS_UNIX
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+ApplianceQueue::ApplianceQueue(int depth, int workers, QObject *parent)
+    : QObject{parent}, m_depth(qMax(1, depth)), m_submissions(m_depth), m_completions(m_depth)
+{
+#ifdef Q_OS_UNIX
+    if (::pipe(m_wake) == 0) {
+        for (int fd : m_wake) {
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+            fcntl(fd, F_SETFD, FD_CLOEXEC);
+        }
+        // A child, so it follows the queue if it is moved to another thread
+        m_wakeNotifier = new QSocketNotifier(m_wake[0], QSocketNotifier::Read, this);
+        connect(m_wakeNotifier, &QSocketNotifier::activated, this, [this] {
+            char drained[16];
+            while (::read(m_wake[0], drained, sizeof(drained)) > 0) {}
+            delivered();
+        });
+    } else {
+        qWarning() << "ApplianceQueue: no wake pipe, falling back to queued calls";
+    }
+#endif
+
+    if (workers <= 0) workers = qMax(1, QThread::idealThreadCount());
+    for (int i = 0; i < workers; i++) {
+        m_workers.append(QThread::create([this] { work(); }));
+        m_workers.last()->start();
+    }
+}
+
+ApplianceQueue::~ApplianceQueue()
+{
+    // Operations already running finish; ones still queued are dropped
+    m_stopping = true;
+    m_pending.release(m_workers.size());
+    for (QThread *worker : m_workers) {
+        worker->wait();
+        delete worker;
+    }
+#ifdef Q_OS_UNIX
+    delete m_wakeNotifier;
+    for (int fd : m_wake) {
+        if (fd >= 0) ::close(fd);
+    }
+#endif
+}
+
+void ApplianceQueue::setSimulatedLatency(int usecs)
+{
+    m_latency = qMax(0, usecs);
+}
+
+bool ApplianceQueue::submit(Appliance *appliance, Operation operation, quint64 tag)
+{
+    // Claiming a slot first guarantees the completion ring always has room
+    if (m_inFlight.fetch_add(1, std::memory_order_relaxed) >= m_depth) {
+        m_inFlight.fetch_sub(1, std::memory_order_relaxed);
+        return false;
+    }
+    m_submissions.push({tag, appliance, operation}); // Can't fail: at most depth entries in either ring
+    m_pending.release();
+    return true;
+}
+
+int ApplianceQueue::reap(Completion *completions, int max)
+{
+    int reaped = 0;
+    while (reaped < max && m_completions.pop(completions[reaped])) reaped++;
+    m_inFlight.fetch_sub(reaped, std::memory_order_relaxed);
+    return reaped;
+}
+
+int ApplianceQueue::reap(QVector<Completion> &completions, int max)
+{
+    completions.resize(max);
+    const int reaped = reap(completions.data(), max);
+    completions.resize(reaped);
+    return reaped;
+}
+
+int ApplianceQueue::depth() const
+{
+    return m_depth;
+}
+
+int ApplianceQueue::inFlight() const
+{
+    return m_inFlight.load(std::memory_order_relaxed);
+}
+
+void ApplianceQueue::work()
+{
+    for (;;) {
+        m_pending.acquire();
+        if (m_stopping) return;
+
+        // The semaphore says an entry exists; a push racing with us may need a moment
+        Submission submission;
+        while (!m_submissions.pop(submission)) QThread::yieldCurrentThread();
+
+        bool result = false;
+        switch (submission.operation) {
+        case Cook: result = submission.appliance->cook(); break;
+        case Grill: result = submission.appliance->grill(); break;
+        case Freeze: result = submission.appliance->freeze(); break;
+        }
+        if (const int latency = m_latency.load(std::memory_order_relaxed)) QThread::usleep(ulong(latency));
+
+        m_completions.push({submission.tag, submission.appliance, submission.operation, result});
+        announce();
+    }
+}
+
+void ApplianceQueue::announce()
+{
+    // Only the first completion after the last delivery wakes the queue's thread,
+    // so the pipe never holds more than a byte
+    if (m_announced.exchange(true, std::memory_order_acq_rel)) return;
+#ifdef Q_OS_UNIX
+    if (m_wakeNotifier) {
+        const char wake = 1;
+        while (::write(m_wake[1], &wake, 1) < 0 && errno == EINTR) {}
+        return;
+    }
+#endif
+    QMetaObject::invokeMethod(this, [this] { delivered(); }, Qt::QueuedConnection);
+}
+
+void ApplianceQueue::delivered()
+{
+    m_announced.exchange(false, std::memory_order_acq_rel); // Pairs with the workers, so their completions are visible
+    emit completionsReady();
+}
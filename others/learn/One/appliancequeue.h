@@ -0,0 +1,81 @@
+#ifndef APPLIANCEQUEUE_H
+#define APPLIANCEQUEUE_H
+
+#include <QObject>
+#include <QSemaphore>
+#include <QSocketNotifier>
+#include <QThread>
+#include <QVector>
+#include <atomic>
+#include "appliance.h"
+#include "mpmcring.h"
+
+// Asynchronous cook()/grill()/freeze(). Operations go into a submission ring and
+// are carried out by a pool of worker threads; results come back through a
+// completion ring, each carrying the caller's tag. submit() never blocks: it
+// fails when depth operations are already in flight. Workers announce finished
+// work once per batch, not per operation: on Unix by writing a byte to a pipe
+// watched by a QSocketNotifier, elsewhere with a queued call. reap() then drains
+// completions in batches. Nothing is allocated per operation on Unix.
+// completionsReady() is emitted in the thread the queue lives in, not the thread
+// that called submit(); callers on other threads connect to it with a queued
+// connection or reap() themselves. The appliances are called from worker threads.
+class ApplianceQueue : public QObject
+{
+    Q_OBJECT
+public:
+    enum Operation : quint8 {
+        Cook,
+        Grill,
+        Freeze
+    };
+    Q_ENUM(Operation)
+
+    struct Completion {
+        quint64 tag;
+        Appliance *appliance;
+        Operation operation;
+        bool result;
+    };
+
+    explicit ApplianceQueue(int depth = 1024, int workers = 0, QObject *parent = nullptr); // 0 workers means one per core
+    ~ApplianceQueue();
+
+    // Stands in for device time in load tests: each operation also sleeps this long
+    void setSimulatedLatency(int usecs);
+
+    bool submit(Appliance *appliance, Operation operation, quint64 tag);
+    int reap(Completion *completions, int max);
+    int reap(QVector<Completion> &completions, int max = 256);
+
+    int depth() const;
+    int inFlight() const;
+
+signals:
+    void completionsReady();
+
+private:
+    struct Submission {
+        quint64 tag;
+        Appliance *appliance;
+        Operation operation;
+    };
+
+    void work();
+    void announce();
+    void delivered();
+
+    const int m_depth;
+    MpmcRing<Submission> m_submissions;
+    MpmcRing<Completion> m_completions;
+    QSemaphore m_pending;
+    std::atomic<int> m_inFlight{0};
+    std::atomic<bool> m_announced{false};
+    std::atomic<bool> m_stopping{false};
+    std::atomic<int> m_latency{0};
+    QVector<QThread *> m_workers;
+    int m_wake[2] = {-1, -1};
+    QSocketNotifier *m_wakeNotifier = nullptr;
+};
+
+#endif // APPLIANCEQUEUE_H
@@ -0,0 +1,178 @@
+#include "boundedqueue.h"
+#include <QThread>
+#include <QVector>
+
+BoundedQueue::BoundedQueue(Radio *radio, int capacity, Policy policy)
+    : QObject{radio}, m_radio{radio}, m_capacity{qMax(1, capacity)}, m_policy{policy}
+{
+    m_clock.start();
+    m_lingerTimer.setSingleShot(true);
+    connect(&m_lingerTimer, &QTimer::timeout, this, &BoundedQueue::drain);
+}
+
+void BoundedQueue::attach(Station *station)
+{
+    // Direct: push() runs on the producer's thread, drain() on ours.
+    connect(station, &Station::send, this, &BoundedQueue::push, Qt::DirectConnection);
+}
+
+void BoundedQueue::detach(Station *station)
+{
+    disconnect(station, &Station::send, this, &BoundedQueue::push);
+}
+
+int BoundedQueue::capacity() const
+{
+    return m_capacity;
+}
+
+BoundedQueue::Policy BoundedQueue::policy() const
+{
+    return m_policy;
+}
+
+void BoundedQueue::setBatching(int maxBatch, int lingerMsecs)
+{
+    QMutexLocker locker(&m_mutex);
+    m_maxBatch = qMax(0, maxBatch);
+    m_linger = m_maxBatch > 0 ? qMax(0, lingerMsecs) : 0;
+}
+
+int BoundedQueue::maxBatch() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_maxBatch;
+}
+
+int BoundedQueue::linger() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_linger;
+}
+
+int BoundedQueue::size() const
+{
+    QMutexLocker locker(&m_mutex);
+    return int(m_queue.size());
+}
+
+quint64 BoundedQueue::delivered() const
+{
+    return m_delivered.load(std::memory_order_relaxed);
+}
+
+quint64 BoundedQueue::dropped() const
+{
+    return m_dropped.load(std::memory_order_relaxed);
+}
+
+quint64 BoundedQueue::blocked() const
+{
+    return m_blocked.load(std::memory_order_relaxed);
+}
+
+quint64 BoundedQueue::coalesced() const
+{
+    return m_coalesced.load(std::memory_order_relaxed);
+}
+
+quint64 BoundedQueue::batches() const
+{
+    return m_batches.load(std::memory_order_relaxed);
+}
+
+void BoundedQueue::push(int channel, QString name, QString message)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (m_policy == CoalesceByChannel) {
+        auto it = m_pending.constFind(channel);
+        if (it != m_pending.constEnd()) {
+            Broadcast &queued = m_queue[size_t(it.value() - m_headSequence)];
+            queued.name = name;
+            queued.message = message;
+            m_coalesced.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+
+    if (int(m_queue.size()) >= m_capacity) {
+        // Blocking on the radio's own thread would never be woken up.
+        bool canBlock = m_policy == Block && QThread::currentThread() != thread();
+
+        if (canBlock) {
+            m_blocked.fetch_add(1, std::memory_order_relaxed);
+            while (int(m_queue.size()) >= m_capacity) m_notFull.wait(&m_mutex);
+        } else if (m_policy == DropOldest) {
+            popFront();
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+
+    if (m_policy == CoalesceByChannel) m_pending.insert(channel, m_headSequence + m_queue.size());
+    m_queue.push_back(Broadcast{channel, name, message});
+
+    if (!m_scheduled) {
+        m_scheduled = true;
+        m_firstQueued = m_clock.nsecsElapsed();
+        QMetaObject::invokeMethod(this, [this] { drain(); }, Qt::QueuedConnection);
+    } else if (m_lingering && int(m_queue.size()) >= m_maxBatch) {
+        // A full batch does not wait out the linger time
+        m_lingering = false;
+        QMetaObject::invokeMethod(this, [this] { drain(); }, Qt::QueuedConnection);
+    }
+}
+
+void BoundedQueue::popFront()
+{
+    if (m_policy == CoalesceByChannel) m_pending.remove(m_queue.front().channel);
+    m_queue.pop_front();
+    m_headSequence++;
+}
+
+void BoundedQueue::drain()
+{
+    QVector<Broadcast> batch;
+    int maxBatch;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_queue.empty()) return;
+
+        maxBatch = m_maxBatch;
+        if (m_linger > 0 && int(m_queue.size()) < m_maxBatch) {
+            qint64 waited = (m_clock.nsecsElapsed() - m_firstQueued) / 1000000;
+            if (waited < m_linger) {
+                m_lingering = true;
+                locker.unlock();
+                m_lingerTimer.start(int(m_linger - waited));
+                return;
+            }
+        }
+        m_lingering = false;
+
+        batch.reserve(int(m_queue.size()));
+        for (Broadcast &item : m_queue) batch.append(std::move(item));
+        m_headSequence += m_queue.size();
+        m_queue.clear();
+        m_pending.clear();
+        m_scheduled = false;
+        m_notFull.wakeAll();
+    }
+
+    m_lingerTimer.stop();
+
+    if (maxBatch == 0) {
+        for (const Broadcast &item : batch) {
+            m_radio->listen(item.channel, item.name, item.message);
+        }
+    } else {
+        for (int offset = 0; offset < batch.size(); offset += maxBatch) {
+            m_radio->listenBatch(BroadcastSpan{batch.constData() + offset, qMin(maxBatch, batch.size() - offset)});
+            m_batches.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    m_delivered.fetch_add(quint64(batch.size()), std::memory_order_relaxed);
+}
@@ -0,0 +1,88 @@
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+
+#include <QObject>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QTimer>
+#include <QWaitCondition>
+#include <atomic>
+#include <deque>
+#include "broadcast.h"
+#include "radio.h"
+#include "station.h"
+
+// Bounded replacement for a Qt::QueuedConnection between Stations and a Radio.
+// Producers push into a fixed-capacity queue on their own thread and post one
+// drain event per round to the radio's thread, plus one early drain when a batch
+// fills while the linger timer is pending, so the posted-event queue can not grow
+// without bound. With batching on, the radio gets spans through listenBatch()
+// instead of one listen() call per message.
+class BoundedQueue : public QObject
+{
+    Q_OBJECT
+public:
+    enum Policy {
+        Block,              // Producer waits until the radio catches up
+        DropNewest,         // Incoming message is discarded when full
+        DropOldest,         // Oldest queued message is discarded when full
+        CoalesceByChannel   // Keep only the latest pending message per channel
+    };
+    Q_ENUM(Policy)
+
+    explicit BoundedQueue(Radio *radio, int capacity = 1024, Policy policy = Block);
+
+    void attach(Station *station);
+    void detach(Station *station);
+
+    int capacity() const;
+    Policy policy() const;
+
+    // Deliver up to maxBatch messages per listenBatch() call, waiting up to lingerMsecs
+    // for a batch to fill. maxBatch 0 goes back to one listen() per message.
+    void setBatching(int maxBatch, int lingerMsecs = 0);
+    int maxBatch() const;
+    int linger() const;
+    int size() const;
+
+    quint64 delivered() const;
+    quint64 dropped() const;
+    quint64 blocked() const;
+    quint64 coalesced() const;
+    quint64 batches() const;
+
+public slots:
+    void push(int channel, QString name, QString message);
+
+private:
+    void drain();
+    void popFront();
+
+    Radio *m_radio;
+    const int m_capacity;
+    const Policy m_policy;
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_notFull;
+    std::deque<Broadcast> m_queue;
+    QHash<int, quint64> m_pending; // channel -> sequence of its queued message
+    quint64 m_headSequence = 0;
+    bool m_scheduled = false;
+    bool m_lingering = false;
+    qint64 m_firstQueued = 0;
+
+    int m_maxBatch = 0;
+    int m_linger = 0;
+    QElapsedTimer m_clock;
+    QTimer m_lingerTimer;
+
+    std::atomic<quint64> m_delivered{0};
+    std::atomic<quint64> m_dropped{0};
+    std::atomic<quint64> m_blocked{0};
+    std::atomic<quint64> m_coalesced{0};
+    std::atomic<quint64> m_batches{0};
+};
+
+#endif // BOUNDEDQUEUE_H
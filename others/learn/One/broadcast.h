@@ -0,0 +1,22 @@
+#ifndef BROADCAST_H
+#define BROADCAST_H
+
+#include <QString>
+
+// One Station::send, held by value so it can be queued or batched.
+struct Broadcast {
+    int channel;
+    QString name;
+    QString message;
+};
+
+// Contiguous run of broadcasts handed to Radio::listenBatch in one call.
+struct BroadcastSpan {
+    const Broadcast *data;
+    int size;
+
+    const Broadcast *begin() const { return data; }
+    const Broadcast *end() const { return data + size; }
+};
+
+#endif // BROADCAST_H
@@ -3,5 +3,6 @@
 Canine::Canine(QObject *parent)
     : Mammal{parent}
 {
-    qInfo() << this << "Constructed";
+    m_type = CanineType;
+    if (!quiet) qInfo() << this << "Constructed";
 }
@@ -11,6 +11,9 @@ class Canine : public Mammal
 public:
     explicit Canine(QObject *parent = nullptr);
 
+    static constexpr quint8 TypeFirst = CanineType;
+    static constexpr quint8 TypeLast = CanineType;
+
     void bark() {
         qInfo() << "BARK!";
     }
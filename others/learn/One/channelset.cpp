@@ -0,0 +1,57 @@
+#include "channelset.h"
+#include <QDebug>
+
+bool ChannelSet::insert(int channel)
+{
+    if (!isValid(channel)) {
+        qWarning() << "ChannelSet: channel" << channel << "is outside 0 to" << Capacity - 1;
+        return false;
+    }
+    m_words[channel >> 6].fetch_or(quint64(1) << (channel & 63), std::memory_order_relaxed);
+    return true;
+}
+
+bool ChannelSet::remove(int channel)
+{
+    if (!isValid(channel)) {
+        qWarning() << "ChannelSet: channel" << channel << "is outside 0 to" << Capacity - 1;
+        return false;
+    }
+    m_words[channel >> 6].fetch_and(~(quint64(1) << (channel & 63)), std::memory_order_relaxed);
+    return true;
+}
+
+void ChannelSet::clear()
+{
+    for (std::atomic<quint64> &word : m_words) word.store(0, std::memory_order_relaxed);
+}
+
+bool ChannelSet::isEmpty() const
+{
+    for (const std::atomic<quint64> &word : m_words) {
+        if (word.load(std::memory_order_relaxed)) return false;
+    }
+    return true;
+}
+
+int ChannelSet::count() const
+{
+    int total = 0;
+    for (const std::atomic<quint64> &word : m_words) {
+        quint64 bits = word.load(std::memory_order_relaxed);
+        while (bits) {
+            bits &= bits - 1;
+            total++;
+        }
+    }
+    return total;
+}
+
+QList<int> ChannelSet::channels() const
+{
+    QList<int> list;
+    for (int channel = 0; channel < Capacity; channel++) {
+        if (contains(channel)) list.append(channel);
+    }
+    return list;
+}
@@ -0,0 +1,40 @@
+#ifndef CHANNELSET_H
+#define CHANNELSET_H
+
+#include <QtGlobal>
+#include <QList>
+#include <atomic>
+
+// Bitmap of channel numbers 0..Capacity-1. Readers on any thread only do relaxed
+// loads, so a Station can consult a Radio's set on every broadcast. Channels outside
+// that range are refused with a warning rather than dropped quietly.
+class ChannelSet
+{
+public:
+    static constexpr int Capacity = 1024;
+
+    ChannelSet() = default;
+    ChannelSet(const ChannelSet &) = delete;
+    ChannelSet &operator=(const ChannelSet &) = delete;
+
+    bool contains(int channel) const {
+        if (!isValid(channel)) return false;
+        return (m_words[channel >> 6].load(std::memory_order_relaxed) >> (channel & 63)) & 1;
+    }
+
+    static bool isValid(int channel) { return uint(channel) < uint(Capacity); }
+
+    // False, with a warning, when the channel does not fit
+    bool insert(int channel);
+    bool remove(int channel);
+    void clear();
+
+    bool isEmpty() const;
+    int count() const;
+    QList<int> channels() const;
+
+private:
+    std::atomic<quint64> m_words[Capacity / 64] = {};
+};
+
+#endif // CHANNELSET_H
@@ -0,0 +1,307 @@
+#include "consolesink.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QList>
+#include <QMutex>
+#include <QThread>
+#include <QVarLengthArray>
+#include <QVector>
+#include <QWaitCondition>
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef Q_OS_UNIX
+#include <csignal>
+#include <sys/uio.h>
+#include <unistd.h>
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+#endif
+
+namespace {
+
+constexpr int ChunkSize = 16 * 1024;
+
+struct Chunk {
+    QByteArray data;
+    int used = 0;
+};
+
+struct ThreadBuffer {
+    QMutex mutex;
+    QVector<Chunk> chunks;
+    int current = 0;
+    qint64 bytes = 0;
+    qint64 oldest = -1;
+};
+
+struct Sink {
+    QMutex mutex;
+    QList<ThreadBuffer *> buffers;
+    std::atomic<int> fd{2};
+    std::atomic<qint64> maxBytes{256 * 1024};
+    std::atomic<int> maxDelay{50};
+    std::atomic<bool> installed{false};
+    QtMessageHandler previous = nullptr;
+    QElapsedTimer clock;
+
+    QThread *flusher = nullptr;
+    QWaitCondition wake;
+    bool running = false;
+};
+
+Sink &sink()
+{
+    static Sink instance;
+    return instance;
+}
+
+void writeAll(int fd, QVector<Chunk> &chunks)
+{
+#ifdef Q_OS_UNIX
+    QVarLengthArray<iovec, 64> vectors;
+    for (Chunk &chunk : chunks) {
+        if (chunk.used) vectors.append(iovec{chunk.data.data(), size_t(chunk.used)});
+    }
+
+    iovec *next = vectors.data();
+    int left = vectors.size();
+    while (left > 0) {
+        ssize_t written = ::writev(fd, next, qMin(left, IOV_MAX));
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        while (left > 0 && size_t(written) >= next->iov_len) {
+            written -= ssize_t(next->iov_len);
+            next++;
+            left--;
+        }
+        if (left > 0) {
+            next->iov_base = static_cast<char *>(next->iov_base) + written;
+            next->iov_len -= size_t(written);
+        }
+    }
+#else
+    FILE *stream = fd == 1 ? stdout : stderr;
+    for (const Chunk &chunk : chunks) fwrite(chunk.data.constData(), 1, size_t(chunk.used), stream);
+    fflush(stream);
+#endif
+}
+
+void flushBuffer(ThreadBuffer &buffer)
+{
+    if (buffer.bytes == 0) return;
+    writeAll(sink().fd.load(std::memory_order_relaxed), buffer.chunks);
+    for (Chunk &chunk : buffer.chunks) chunk.used = 0;
+    buffer.current = 0;
+    buffer.bytes = 0;
+    buffer.oldest = -1;
+}
+
+// Room for at least `needed` more bytes in the current chunk, moving on or growing as required
+Chunk &reserve(ThreadBuffer &buffer, int needed)
+{
+    if (buffer.chunks.isEmpty()) buffer.chunks.append(Chunk{QByteArray(ChunkSize, Qt::Uninitialized), 0});
+
+    Chunk *chunk = &buffer.chunks[buffer.current];
+    if (chunk->data.size() - chunk->used >= needed) return *chunk;
+
+    if (chunk->used > 0) buffer.current++;
+    if (buffer.current == buffer.chunks.size()) {
+        buffer.chunks.append(Chunk{QByteArray(qMax(ChunkSize, needed), Qt::Uninitialized), 0});
+    }
+    chunk = &buffer.chunks[buffer.current];
+    if (chunk->data.size() < needed) chunk->data.resize(needed);
+    return *chunk;
+}
+
+char *encodeUtf8(char *out, QStringView text)
+{
+    const QChar *it = text.data();
+    const QChar *end = it + text.size();
+    while (it < end) {
+        uint c = it->unicode();
+        it++;
+        if (c < 0x80) {
+            *out++ = char(c);
+        } else if (c < 0x800) {
+            *out++ = char(0xC0 | (c >> 6));
+            *out++ = char(0x80 | (c & 0x3F));
+        } else if (QChar::isHighSurrogate(c) && it < end && it->isLowSurrogate()) {
+            c = QChar::surrogateToUcs4(ushort(c), it->unicode());
+            it++;
+            *out++ = char(0xF0 | (c >> 18));
+            *out++ = char(0x80 | ((c >> 12) & 0x3F));
+            *out++ = char(0x80 | ((c >> 6) & 0x3F));
+            *out++ = char(0x80 | (c & 0x3F));
+        } else {
+            if (QChar::isSurrogate(c)) c = QChar::ReplacementCharacter;
+            *out++ = char(0xE0 | (c >> 12));
+            *out++ = char(0x80 | ((c >> 6) & 0x3F));
+            *out++ = char(0x80 | (c & 0x3F));
+        }
+    }
+    return out;
+}
+
+struct LocalBuffer {
+    ThreadBuffer *buffer = nullptr;
+
+    ~LocalBuffer() {
+        if (!buffer) return;
+        Sink &s = sink();
+        QMutexLocker registry(&s.mutex);
+        s.buffers.removeOne(buffer);
+        registry.unlock();
+        flushBuffer(*buffer);
+        delete buffer;
+    }
+};
+
+ThreadBuffer &localBuffer()
+{
+    thread_local LocalBuffer local;
+    if (!local.buffer) {
+        local.buffer = new ThreadBuffer;
+        Sink &s = sink();
+        QMutexLocker registry(&s.mutex);
+        s.buffers.append(local.buffer);
+    }
+    return *local.buffer;
+}
+
+void flushOld()
+{
+    Sink &s = sink();
+    const qint64 now = s.clock.elapsed();
+    const int delay = s.maxDelay.load(std::memory_order_relaxed);
+    QMutexLocker registry(&s.mutex);
+    for (ThreadBuffer *buffer : s.buffers) {
+        QMutexLocker locker(&buffer->mutex);
+        if (buffer->oldest >= 0 && now - buffer->oldest >= delay) flushBuffer(*buffer);
+    }
+}
+
+#ifdef Q_OS_UNIX
+void crashed(int signal)
+{
+    // Best effort: the crashing thread may hold its own buffer's lock, so take none
+    for (ThreadBuffer *buffer : sink().buffers) {
+        writeAll(sink().fd.load(std::memory_order_relaxed), buffer->chunks);
+    }
+    ::signal(signal, SIG_DFL);
+    ::raise(signal);
+}
+#endif
+
+} // namespace
+
+void ConsoleSink::install(int fd)
+{
+    Sink &s = sink();
+    if (s.installed.exchange(true)) return;
+
+    s.fd = fd;
+    s.clock.start();
+    s.previous = qInstallMessageHandler(handler);
+
+    s.running = true;
+    s.flusher = QThread::create([&s] {
+        QMutexLocker locker(&s.mutex);
+        while (s.running) {
+            s.wake.wait(&s.mutex, ulong(qMax(1, s.maxDelay.load() / 2)));
+            locker.unlock();
+            flushOld();
+            locker.relock();
+        }
+    });
+    s.flusher->start();
+
+    if (QCoreApplication *app = QCoreApplication::instance()) {
+        QObject::connect(app, &QCoreApplication::aboutToQuit, app, &ConsoleSink::flush);
+    }
+
+    static bool registered = false;
+    if (!registered) {
+        registered = true;
+        std::atexit(ConsoleSink::uninstall);
+#ifdef Q_OS_UNIX
+        for (int signal : {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT}) ::signal(signal, crashed);
+#endif
+    }
+}
+
+void ConsoleSink::uninstall()
+{
+    Sink &s = sink();
+    if (!s.installed.exchange(false)) return;
+
+    qInstallMessageHandler(s.previous);
+    {
+        QMutexLocker locker(&s.mutex);
+        s.running = false;
+        s.wake.wakeAll();
+    }
+    s.flusher->wait();
+    delete s.flusher;
+    s.flusher = nullptr;
+    flush();
+}
+
+bool ConsoleSink::isInstalled()
+{
+    return sink().installed.load();
+}
+
+void ConsoleSink::setThresholds(qint64 bytes, int msecs)
+{
+    sink().maxBytes = qMax<qint64>(1, bytes);
+    sink().maxDelay = qMax(1, msecs);
+}
+
+void ConsoleSink::write(QStringView line)
+{
+    ThreadBuffer &buffer = localBuffer();
+    QMutexLocker locker(&buffer.mutex);
+
+    // Worst case three UTF-8 bytes per UTF-16 unit, plus the newline
+    const int needed = int(line.size()) * 3 + 1;
+    Chunk &chunk = reserve(buffer, needed);
+    char *start = chunk.data.data() + chunk.used;
+    char *end = encodeUtf8(start, line);
+    *end++ = '\n';
+    chunk.used += int(end - start);
+    buffer.bytes += end - start;
+
+    Sink &s = sink();
+    const qint64 now = s.clock.elapsed();
+    if (buffer.oldest < 0) buffer.oldest = now;
+    if (buffer.bytes >= s.maxBytes.load(std::memory_order_relaxed)
+        || now - buffer.oldest >= s.maxDelay.load(std::memory_order_relaxed)) {
+        flushBuffer(buffer);
+    }
+}
+
+void ConsoleSink::flush()
+{
+    Sink &s = sink();
+    QMutexLocker registry(&s.mutex);
+    for (ThreadBuffer *buffer : s.buffers) {
+        QMutexLocker locker(&buffer->mutex);
+        flushBuffer(*buffer);
+    }
+}
+
+void ConsoleSink::handler(QtMsgType type, const QMessageLogContext &context, const QString &message)
+{
+    write(qFormatLogMessage(type, context, message));
+
+    // qFatal aborts right after this returns
+    if (type == QtFatalMsg) flush();
+}
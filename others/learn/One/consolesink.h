@@ -0,0 +1,29 @@
+#ifndef CONSOLESINK_H
+#define CONSOLESINK_H
+
+#include <QtGlobal>
+#include <QStringView>
+
+// Message handler that encodes qInfo() and friends straight to UTF-8 in per-thread
+// buffers and writes them out with writev() once a buffer is big or old enough.
+// Buffers are also flushed on quit, at exit, on qFatal and on fatal signals.
+// Lines from one thread keep their order; lines from different threads may
+// interleave in chunks rather than one by one.
+class ConsoleSink
+{
+public:
+    static void install(int fd = 2);
+    static void uninstall();
+    static bool isInstalled();
+
+    // Flush a thread's buffer once it holds this many bytes or its oldest line is this old
+    static void setThresholds(qint64 bytes, int msecs);
+
+    static void write(QStringView line);
+    static void flush();
+
+private:
+    static void handler(QtMsgType type, const QMessageLogContext &context, const QString &message);
+};
+
+#endif // CONSOLESINK_H
@@ -0,0 +1,234 @@
+#include "consumergroup.h"
+#include <QHash>
+
+ConsumerGroup::ConsumerGroup(const QString &name, int partitions, QObject *parent)
+    : QObject{parent}, m_name{name}, m_partitions{qMax(1, partitions)},
+      m_offsets{std::make_shared<Offsets>(m_partitions)}, m_owners(m_partitions, nullptr)
+{}
+
+QString ConsumerGroup::name() const
+{
+    return m_name;
+}
+
+int ConsumerGroup::partitions() const
+{
+    return m_partitions;
+}
+
+int ConsumerGroup::partitionOf(int channel) const
+{
+    // Unseeded so every process on the host agrees on the mapping
+    return int(qHash(channel, 0) % uint(m_partitions));
+}
+
+void ConsumerGroup::join(Radio *radio)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_members.contains(radio)) return;
+        m_members.append(radio);
+        rebalance();
+        // Messages held while nobody owned their partition
+        deliver(retarget(nullptr));
+    }
+
+    // Direct, so the member is gone from the group before its destructor returns
+    connect(radio, &QObject::destroyed, this, [this, radio] { memberDestroyed(radio); }, Qt::DirectConnection);
+    emit rebalanced();
+}
+
+void ConsumerGroup::leave(Radio *radio)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_members.removeOne(radio)) return;
+        rebalance();
+        // Its queued deliveries may yet be dropped if it is deleted before they run,
+        // so the new owners get them too; whichever finishes first commits
+        deliver(retarget(radio));
+    }
+
+    disconnect(radio, &QObject::destroyed, this, nullptr);
+    emit rebalanced();
+}
+
+void ConsumerGroup::memberDestroyed(Radio *radio)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_members.removeOne(radio)) return;
+        rebalance();
+        // Its queued deliveries died with it
+        deliver(retarget(radio));
+    }
+    emit rebalanced();
+}
+
+// Points everything still waiting on from at the partition's current owner, or
+// parks it for the next member to join when there is none
+QList<ConsumerGroup::Delivery> ConsumerGroup::retarget(Radio *from)
+{
+    QList<Delivery> deliveries;
+    for (int partition = 0; partition < m_partitions; partition++) {
+        Radio *owner = m_owners.at(partition);
+        if (!owner && !from) continue;
+        Partition &state = m_offsets->partitions[size_t(partition)];
+        QMutexLocker locker(&state.mutex);
+        for (auto &[offset, pending] : state.pending) {
+            if (pending.done || pending.target != from) continue;
+            pending.target = owner;
+            if (owner) deliveries.append({owner, partition, offset, pending.broadcast});
+        }
+    }
+    return deliveries;
+}
+
+// Called with m_mutex held, so no member can be destroyed halfway through
+void ConsumerGroup::deliver(const QList<Delivery> &deliveries)
+{
+    for (const Delivery &delivery : deliveries) {
+        std::shared_ptr<Offsets> offsets = m_offsets;
+        // Runs on the member's thread; dropped with the member if it goes away first
+        QMetaObject::invokeMethod(delivery.radio, [offsets, delivery] {
+            delivery.radio->listen(delivery.broadcast.channel, delivery.broadcast.name, delivery.broadcast.message);
+            offsets->commit(delivery.partition, delivery.offset);
+        }, Qt::AutoConnection);
+    }
+}
+
+void ConsumerGroup::Offsets::commit(int partition, quint64 offset)
+{
+    Partition &state = partitions[size_t(partition)];
+    QMutexLocker locker(&state.mutex);
+    auto it = state.pending.find(offset);
+    if (it == state.pending.end()) return; // From before a loadOffsets()
+    it->second.done = true;
+
+    // Only a contiguous run of finished offsets moves the mark
+    while (!state.pending.empty() && state.pending.begin()->second.done) state.pending.erase(state.pending.begin());
+    const quint64 mark = state.pending.empty() ? state.end.load(std::memory_order_relaxed) : state.pending.begin()->first;
+    state.committed.store(mark, std::memory_order_release);
+}
+
+void ConsumerGroup::rebalance()
+{
+    for (int partition = 0; partition < m_partitions; partition++) {
+        m_owners[partition] = m_members.isEmpty() ? nullptr : m_members.at(partition % m_members.size());
+    }
+}
+
+QList<Radio *> ConsumerGroup::members() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_members;
+}
+
+Radio *ConsumerGroup::owner(int partition) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_owners.value(partition);
+}
+
+QList<int> ConsumerGroup::assignment(Radio *radio) const
+{
+    QMutexLocker locker(&m_mutex);
+    QList<int> partitions;
+    for (int partition = 0; partition < m_partitions; partition++) {
+        if (m_owners.at(partition) == radio) partitions.append(partition);
+    }
+    return partitions;
+}
+
+quint64 ConsumerGroup::endOffset(int partition) const
+{
+    return m_offsets->partitions.at(size_t(partition)).end.load(std::memory_order_acquire);
+}
+
+quint64 ConsumerGroup::committedOffset(int partition) const
+{
+    return m_offsets->partitions.at(size_t(partition)).committed.load(std::memory_order_acquire);
+}
+
+quint64 ConsumerGroup::lag() const
+{
+    quint64 total = 0;
+    for (int partition = 0; partition < m_partitions; partition++) {
+        total += endOffset(partition) - committedOffset(partition);
+    }
+    return total;
+}
+
+void ConsumerGroup::saveOffsets(QSettings &settings) const
+{
+    settings.beginGroup(m_name);
+    for (int partition = 0; partition < m_partitions; partition++) {
+        Partition &state = m_offsets->partitions[size_t(partition)];
+        QMutexLocker locker(&state.mutex);
+        settings.setValue(QString::number(partition), state.committed.load(std::memory_order_relaxed));
+
+        // What is still unheard goes along, so a restart picks up where this left off
+        const QString array = QString("pending%1").arg(partition);
+        settings.remove(array);
+        settings.beginWriteArray(array);
+        int index = 0;
+        for (const auto &[offset, pending] : state.pending) {
+            if (pending.done) continue;
+            settings.setArrayIndex(index++);
+            settings.setValue("channel", pending.broadcast.channel);
+            settings.setValue("name", pending.broadcast.name);
+            settings.setValue("message", pending.broadcast.message);
+        }
+        settings.endArray();
+    }
+    settings.endGroup();
+}
+
+void ConsumerGroup::loadOffsets(QSettings &settings)
+{
+    QMutexLocker locker(&m_mutex);
+    QList<Delivery> deliveries;
+    settings.beginGroup(m_name);
+    for (int partition = 0; partition < m_partitions; partition++) {
+        quint64 offset = settings.value(QString::number(partition), 0).toULongLong();
+        Partition &state = m_offsets->partitions[size_t(partition)];
+        Radio *owner = m_owners.at(partition);
+
+        QMutexLocker partitionLocker(&state.mutex);
+        state.pending.clear();
+        state.committed.store(offset, std::memory_order_release);
+
+        const int count = settings.beginReadArray(QString("pending%1").arg(partition));
+        for (int i = 0; i < count; i++) {
+            settings.setArrayIndex(i);
+            Broadcast broadcast{settings.value("channel").toInt(), settings.value("name").toString(),
+                                settings.value("message").toString()};
+            state.pending.emplace(offset, Pending{broadcast, owner, false});
+            if (owner) deliveries.append({owner, partition, offset, broadcast});
+            offset++;
+        }
+        settings.endArray();
+        state.end.store(offset, std::memory_order_release);
+    }
+    settings.endGroup();
+    // Resumed at the committed offset; members joining later get the rest
+    deliver(deliveries);
+}
+
+void ConsumerGroup::publish(int channel, QString name, QString message)
+{
+    const int partition = partitionOf(channel);
+
+    QMutexLocker locker(&m_mutex);
+    Radio *radio = m_owners.at(partition);
+
+    Partition &state = m_offsets->partitions[size_t(partition)];
+    quint64 offset;
+    {
+        QMutexLocker partitionLocker(&state.mutex);
+        offset = state.end.fetch_add(1, std::memory_order_acq_rel);
+        // Without an owner it waits for join()
+        state.pending.emplace(offset, Pending{{channel, name, message}, radio, false});
+    }
+    if (radio) deliver({Delivery{radio, partition, offset, Broadcast{channel, name, message}}});
+}
@@ -0,0 +1,99 @@
+#ifndef CONSUMERGROUP_H
+#define CONSUMERGROUP_H
+
+#include <QObject>
+#include <QDebug>
+#include <QList>
+#include <QMutex>
+#include <QSettings>
+#include <QVector>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <vector>
+#include "broadcast.h"
+#include "radio.h"
+
+// Named group of Radios sharing one Station::send stream. Channels are hashed onto a
+// fixed number of partitions, each partition is owned by exactly one member, and the
+// partitions are spread again whenever a member joins or leaves. Every partition keeps
+// its produced and committed offsets, so the group's lag can be watched or persisted.
+// The committed offset is the low-water mark: everything below it has been listened
+// to. Messages above it are held until then: kept while no member owns their
+// partition, handed to the new owner when their member leaves or is destroyed first
+// (so a leaver's backlog may be heard twice), and saved with the offsets so
+// loadOffsets() delivers them again.
+class ConsumerGroup : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ConsumerGroup(const QString &name, int partitions = 16, QObject *parent = nullptr);
+
+    QString name() const;
+    int partitions() const;
+    int partitionOf(int channel) const;
+
+    void join(Radio *radio);
+    void leave(Radio *radio);
+    QList<Radio *> members() const;
+    Radio *owner(int partition) const;
+    QList<int> assignment(Radio *radio) const;
+
+    quint64 endOffset(int partition) const;
+    quint64 committedOffset(int partition) const;
+    quint64 lag() const;
+
+    void saveOffsets(QSettings &settings) const;
+    void loadOffsets(QSettings &settings);
+
+signals:
+    void rebalanced();
+
+public slots:
+    // A member on the publishing thread hears it before this returns, so its listen()
+    // must not call back into the group
+    void publish(int channel, QString name, QString message);
+
+private:
+    struct Pending {
+        Broadcast broadcast;
+        Radio *target;  // nullptr while no member owns the partition
+        bool done;
+    };
+
+    struct Partition {
+        QMutex mutex;
+        std::atomic<quint64> end{0};
+        std::atomic<quint64> committed{0};
+        std::map<quint64, Pending> pending; // Offsets from committed up to end
+    };
+
+    // Shared with deliveries still queued to members, which may outlive the group
+    struct Offsets {
+        explicit Offsets(int partitions) : partitions(size_t(partitions)) {}
+        void commit(int partition, quint64 offset);
+        std::vector<Partition> partitions;
+    };
+
+    struct Delivery {
+        Radio *radio;
+        int partition;
+        quint64 offset;
+        Broadcast broadcast;
+    };
+
+    void rebalance();
+    void memberDestroyed(Radio *radio);
+    QList<Delivery> retarget(Radio *from);
+    void deliver(const QList<Delivery> &deliveries);
+
+    QString m_name;
+    const int m_partitions;
+    std::shared_ptr<Offsets> m_offsets;
+
+    mutable QMutex m_mutex;
+    QList<Radio *> m_members;
+    QVector<Radio *> m_owners;
+};
+
+#endif // CONSUMERGROUP_H
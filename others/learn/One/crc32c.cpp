@@ -0,0 +1,78 @@
+#include "crc32c.h"
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define CRC32C_X86 1
+#include <nmmintrin.h>
+#elif defined(__ARM_FEATURE_CRC32)
+#define CRC32C_ARM 1
+#include <arm_acle.h>
+#endif
+
+namespace {
+
+constexpr std::array<quint32, 256> makeTable()
+{
+    std::array<quint32, 256> table{};
+    for (quint32 i = 0; i < 256; i++) {
+        quint32 crc = i;
+        for (int bit = 0; bit < 8; bit++) crc = (crc >> 1) ^ (0x82F63B78u & (0u - (crc & 1u)));
+        table[i] = crc;
+    }
+    return table;
+}
+
+constexpr std::array<quint32, 256> table = makeTable();
+
+quint32 software(quint32 crc, const uchar *data, size_t length)
+{
+    while (length--) crc = table[(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+    return crc;
+}
+
+#if defined(CRC32C_X86)
+__attribute__((target("sse4.2")))
+quint32 hardware(quint32 crc, const uchar *data, size_t length)
+{
+    quint64 crc64 = crc;
+    while (length >= 8) {
+        quint64 word;
+        memcpy(&word, data, 8);
+        crc64 = _mm_crc32_u64(crc64, word);
+        data += 8;
+        length -= 8;
+    }
+    crc = quint32(crc64);
+    while (length--) crc = _mm_crc32_u8(crc, *data++);
+    return crc;
+}
+
+const bool hasHardware = __builtin_cpu_supports("sse4.2");
+#elif defined(CRC32C_ARM)
+quint32 hardware(quint32 crc, const uchar *data, size_t length)
+{
+    while (length >= 8) {
+        quint64 word;
+        memcpy(&word, data, 8);
+        crc = __crc32cd(crc, word);
+        data += 8;
+        length -= 8;
+    }
+    while (length--) crc = __crc32cb(crc, *data++);
+    return crc;
+}
+
+const bool hasHardware = true;
+#endif
+
+} // namespace
+
+quint32 crc32c(quint32 crc, const void *data, size_t length)
+{
+    const uchar *bytes = static_cast<const uchar *>(data);
+#if defined(CRC32C_X86) || defined(CRC32C_ARM)
+    if (hasHardware) return ~hardware(~crc, bytes, length);
+#endif
+    return ~software(~crc, bytes, length);
+}
@@ -0,0 +1,11 @@
+#ifndef CRC32C_H
+#define CRC32C_H
+
+#include <QtGlobal>
+#include <cstddef>
+
+// CRC-32C (Castagnoli). Pass the previous result as crc to checksum data in pieces,
+// 0 to start. Uses SSE4.2 or the ARMv8 CRC instructions when the CPU has them.
+quint32 crc32c(quint32 crc, const void *data, size_t length);
+
+#endif // CRC32C_H
@@ -0,0 +1,226 @@
+#include "csvimporter.h"
+#include <QFile>
+#include <QThread>
+#include <cstring>
+#include <vector>
+#include "speciesregistry.h"
+
+#if defined(__SSE2__)
+#define CSV_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#define CSV_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+// One bit per structural byte (',' or '\n') among the 16 at p. NEON has no
+// movemask, so there every byte gets four bits and only the top one is kept.
+#if defined(CSV_SSE2)
+constexpr int BitsPerByte = 1;
+
+inline quint64 structural(const char *p)
+{
+    const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+    const __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(',')), _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\n')));
+    return quint64(quint32(_mm_movemask_epi8(hits)));
+}
+#elif defined(CSV_NEON)
+constexpr int BitsPerByte = 4;
+
+inline quint64 structural(const char *p)
+{
+    const uint8x16_t bytes = vld1q_u8(reinterpret_cast<const uint8_t *>(p));
+    const uint8x16_t hits = vorrq_u8(vceqq_u8(bytes, vdupq_n_u8(',')), vceqq_u8(bytes, vdupq_n_u8('\n')));
+    const uint8x8_t nibbles = vshrn_n_u16(vreinterpretq_u16_u8(hits), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(nibbles), 0) & 0x8888888888888888ULL;
+}
+#endif
+
+struct Chunk
+{
+    const char *begin;
+    const char *end;
+    bool first;
+    AgeBatch batch;
+};
+
+// Digits only, at most three of them, no locale and no allocation
+inline int parseAge(const char *begin, const char *end)
+{
+    if (end > begin && end[-1] == '\r') end--;
+    const qint64 length = end - begin;
+    if (length < 1 || length > 3) return 0;
+
+    int value = 0;
+    for (const char *p = begin; p < end; p++) {
+        const unsigned digit = unsigned(*p - '0');
+        if (digit > 9) return 0;
+        value = value * 10 + int(digit);
+    }
+    return value;
+}
+
+class Parser
+{
+public:
+    Parser(Chunk &chunk, bool skipHeader)
+        : m_chunk(chunk), m_batch(chunk.batch), m_lineStart(chunk.begin), m_skipHeader(skipHeader && chunk.first)
+    {
+        // Names average well under 16 bytes; a rough guess saves most regrowth
+        const qint64 guess = (chunk.end - chunk.begin) / 16;
+        m_batch.ages.reserve(qsizetype(guess));
+        m_batch.nameEnds.reserve(qsizetype(guess));
+        m_batch.names.reserve(qsizetype(guess * 8));
+    }
+
+    void parse()
+    {
+        const char *p = m_chunk.begin;
+        const char *end = m_chunk.end;
+
+#if defined(CSV_SSE2) || defined(CSV_NEON)
+        for (; p + 16 <= end; p += 16) {
+            quint64 mask = structural(p);
+            while (mask) {
+                const int bit = __builtin_ctzll(mask);
+                structuralAt(p + bit / BitsPerByte);
+                mask &= mask - 1;
+            }
+        }
+#endif
+        for (; p < end; p++) {
+            if (*p == ',' || *p == '\n') structuralAt(p);
+        }
+
+        if (m_lineStart < end) lineEnd(end); // Last line without a newline
+    }
+
+private:
+    void structuralAt(const char *p)
+    {
+        if (*p == ',') {
+            if (!m_comma) m_comma = p;
+        } else {
+            lineEnd(p);
+        }
+    }
+
+    void lineEnd(const char *p)
+    {
+        const char *start = m_lineStart;
+        const char *comma = m_comma;
+        m_lineStart = p + 1;
+        m_comma = nullptr;
+        m_batch.lines++;
+
+        if (p == start || (p == start + 1 && *start == '\r')) return;
+        if (m_skipHeader && m_batch.lines == 1) return;
+
+        const int age = comma ? parseAge(comma + 1, p) : 0;
+        if (!SpeciesRegistry::isValidAge(age)) {
+            m_batch.rejected++;
+            if (!m_batch.firstRejectedLine) m_batch.firstRejectedLine = m_batch.lines;
+            return;
+        }
+
+        m_batch.names.append(start, qsizetype(comma - start));
+        m_batch.nameEnds.append(m_batch.names.size());
+        m_batch.ages.append(age);
+    }
+
+    Chunk &m_chunk;
+    AgeBatch &m_batch;
+    const char *m_lineStart;
+    bool m_skipHeader;
+    const char *m_comma = nullptr;
+};
+
+} // namespace
+
+CsvImporter::CsvImporter(const QString &path)
+    : m_path(path), m_threads(qMax(1, QThread::idealThreadCount()))
+{}
+
+void CsvImporter::setThreads(int threads)
+{
+    m_threads = qMax(1, threads);
+}
+
+void CsvImporter::setChunkSize(qint64 bytes)
+{
+    m_chunkSize = qMax<qint64>(4096, bytes);
+}
+
+void CsvImporter::setSkipHeader(bool skip)
+{
+    m_skipHeader = skip;
+}
+
+QString CsvImporter::errorString() const
+{
+    return m_error;
+}
+
+bool CsvImporter::run(const std::function<void(AgeBatch &chunk)> &consume)
+{
+    m_error.clear();
+    QFile file(m_path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        m_error = file.errorString();
+        return false;
+    }
+    const qint64 size = file.size();
+    if (size == 0) return true;
+
+    const char *data = reinterpret_cast<const char *>(file.map(0, size));
+    if (!data) {
+        m_error = file.errorString();
+        return false;
+    }
+    const char *end = data + size;
+
+    // Chunks end just after a newline, so no line is ever split between two
+    const char *next = data;
+    bool first = true;
+    while (next < end) {
+        std::vector<Chunk> round;
+        for (int i = 0; i < m_threads && next < end; i++) {
+            const char *begin = next;
+            const char *stop = begin + qMin<qint64>(m_chunkSize, end - begin);
+            if (stop < end) {
+                const char *newline = static_cast<const char *>(memchr(stop, '\n', size_t(end - stop)));
+                stop = newline ? newline + 1 : end;
+            }
+            round.push_back(Chunk{begin, stop, first, AgeBatch()});
+            first = false;
+            next = stop;
+        }
+
+        auto parse = [this](Chunk &chunk) { Parser(chunk, m_skipHeader).parse(); };
+
+        // The last chunk of a round is parsed here rather than on a thread of its own
+        std::vector<QThread *> threads;
+        for (size_t i = 0; i + 1 < round.size(); i++) {
+            threads.push_back(QThread::create([&parse, &chunk = round[i]] { parse(chunk); }));
+            threads.back()->start();
+        }
+        parse(round.back());
+        for (QThread *thread : threads) {
+            thread->wait();
+            delete thread;
+        }
+
+        for (Chunk &chunk : round) consume(chunk.batch);
+    }
+    return true;
+}
+
+bool CsvImporter::import(AgeBatch &batch)
+{
+    return run([&batch](AgeBatch &chunk) {
+        if (batch.size() == 0 && batch.lines == 0) batch = std::move(chunk);
+        else batch.append(chunk);
+    });
+}
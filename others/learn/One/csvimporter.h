@@ -0,0 +1,40 @@
+#ifndef CSVIMPORTER_H
+#define CSVIMPORTER_H
+
+#include <QString>
+#include <functional>
+#include "agebatch.h"
+
+// Reads "name,age" lines into AgeBatch columns. The file is mapped, split into
+// chunks at line boundaries and the chunks are parsed on several threads at once.
+// Commas and newlines are found 16 bytes at a time with SSE2 or NEON. Ages must
+// be plain digits in 1..120, the range calc() accepts; other lines are counted
+// as rejected and skipped. Empty lines and a trailing \r are ignored. Quoted
+// fields are not supported.
+class CsvImporter
+{
+public:
+    explicit CsvImporter(const QString &path);
+
+    void setThreads(int threads);       // Defaults to QThread::idealThreadCount()
+    void setChunkSize(qint64 bytes);    // Defaults to 64 MB
+    void setSkipHeader(bool skip);      // Treats the first line as a header
+
+    // Hands over one batch per chunk, in file order, so memory stays bounded by
+    // threads x chunk size however big the file is
+    bool run(const std::function<void(AgeBatch &chunk)> &consume);
+
+    // The whole file in one batch
+    bool import(AgeBatch &batch);
+
+    QString errorString() const;
+
+private:
+    QString m_path;
+    int m_threads;
+    qint64 m_chunkSize = 64 * 1024 * 1024;
+    bool m_skipHeader = false;
+    QString m_error;
+};
+
+#endif // CSVIMPORTER_H
@@ -1,4 +1,5 @@
 #include "destination.h"
+#include "logcategories.h"
 
 Destination::Destination(QObject *parent)
     : QObject{parent}
@@ -6,5 +7,5 @@ Destination::Destination(QObject *parent)
 
 void Destination::mySignal(QString message)
 {
-    qInfo() << message;
+    qCInfoGated(lcDestination) << message;
 }
@@ -0,0 +1,304 @@
+#include "epolldispatcher.h"
+#include <QCoreApplication>
+#include <QSocketNotifier>
+#include <QTimerEvent>
+#include <QVector>
+#include <QDebug>
+#include <algorithm>
+#include <functional>
+#include <ctime>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+// Exported by QtCore for the built-in dispatchers
+Q_CORE_EXPORT uint qGlobalPostedEventsCount();
+#endif
+
+namespace {
+
+constexpr int MaxEvents = 256;
+constexpr qint64 NsPerMs = 1000000;
+
+} // namespace
+
+EpollDispatcher::EpollDispatcher(QObject *parent)
+    : QAbstractEventDispatcher{parent}
+{
+    m_epoll = epoll_create1(EPOLL_CLOEXEC);
+    m_wake = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    m_timerfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (m_epoll < 0 || m_wake < 0 || m_timerfd < 0) qFatal("EpollDispatcher: cannot create epoll, eventfd or timerfd");
+
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = m_wake;
+    epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_wake, &event);
+    event.data.fd = m_timerfd;
+    epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_timerfd, &event);
+}
+
+EpollDispatcher::~EpollDispatcher()
+{
+    close(m_timerfd);
+    close(m_wake);
+    close(m_epoll);
+}
+
+qint64 EpollDispatcher::now()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return qint64(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+bool EpollDispatcher::processEvents(QEventLoop::ProcessEventsFlags flags)
+{
+    m_interrupted = false;
+    emit awake();
+    QCoreApplication::sendPostedEvents();
+
+    const bool wait = (flags & QEventLoop::WaitForMoreEvents) && !m_interrupted;
+    if (wait) emit aboutToBlock();
+
+    epoll_event events[MaxEvents];
+    const int ready = epoll_wait(m_epoll, events, MaxEvents, wait ? -1 : 0);
+    if (wait) emit awake();
+    if (ready <= 0) return false;
+
+    int delivered = 0;
+    QVector<QPair<QSocketNotifier *, int>> activated;
+    for (int i = 0; i < ready; i++) {
+        const int fd = events[i].data.fd;
+        if (fd == m_wake) {
+            quint64 value;
+            while (read(m_wake, &value, sizeof value) > 0) {}
+        } else if (fd == m_timerfd) {
+            // Left readable while timers are excluded, so the next pass that runs them
+            // still sees it and nothing has to re-arm it here
+            if (flags & QEventLoop::X11ExcludeTimers) continue;
+            quint64 expirations;
+            while (read(m_timerfd, &expirations, sizeof expirations) > 0) {}
+            m_armed = -1;
+        } else if (!(flags & QEventLoop::ExcludeSocketNotifiers)) {
+            const Notifiers &notifiers = m_notifiers.value(fd);
+            const quint32 what = events[i].events;
+            if (notifiers.read && (what & (EPOLLIN | EPOLLHUP | EPOLLERR))) activated.append({notifiers.read, fd});
+            if (notifiers.write && (what & (EPOLLOUT | EPOLLERR))) activated.append({notifiers.write, fd});
+            if (notifiers.exception && (what & EPOLLPRI)) activated.append({notifiers.exception, fd});
+        }
+    }
+
+    // A notifier may be unregistered by the handler of an earlier one
+    for (const QPair<QSocketNotifier *, int> &entry : activated) {
+        const Notifiers &notifiers = m_notifiers.value(entry.second);
+        if (notifiers.read != entry.first && notifiers.write != entry.first && notifiers.exception != entry.first) continue;
+        QEvent event(QEvent::SockAct);
+        QCoreApplication::sendEvent(entry.first, &event);
+        delivered++;
+    }
+
+    if (!(flags & QEventLoop::X11ExcludeTimers)) delivered += fireTimers();
+    return delivered > 0;
+}
+
+void EpollDispatcher::registerSocketNotifier(QSocketNotifier *notifier)
+{
+    const int fd = int(notifier->socket());
+    const bool existed = m_notifiers.contains(fd);
+    Notifiers &notifiers = m_notifiers[fd];
+    switch (notifier->type()) {
+    case QSocketNotifier::Read: notifiers.read = notifier; break;
+    case QSocketNotifier::Write: notifiers.write = notifier; break;
+    case QSocketNotifier::Exception: notifiers.exception = notifier; break;
+    }
+    updateEpoll(fd, notifiers, existed);
+}
+
+void EpollDispatcher::unregisterSocketNotifier(QSocketNotifier *notifier)
+{
+    const int fd = int(notifier->socket());
+    auto it = m_notifiers.find(fd);
+    if (it == m_notifiers.end()) return;
+
+    if (it->read == notifier) it->read = nullptr;
+    if (it->write == notifier) it->write = nullptr;
+    if (it->exception == notifier) it->exception = nullptr;
+
+    if (!it->read && !it->write && !it->exception) {
+        epoll_ctl(m_epoll, EPOLL_CTL_DEL, fd, nullptr);
+        m_notifiers.erase(it);
+    } else {
+        updateEpoll(fd, *it, true);
+    }
+}
+
+void EpollDispatcher::updateEpoll(int fd, const Notifiers &notifiers, bool existed)
+{
+    epoll_event event = {};
+    event.data.fd = fd;
+    if (notifiers.read) event.events |= EPOLLIN;
+    if (notifiers.write) event.events |= EPOLLOUT;
+    if (notifiers.exception) event.events |= EPOLLPRI;
+    if (epoll_ctl(m_epoll, existed ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, fd, &event) != 0) {
+        qWarning() << "EpollDispatcher: cannot watch socket" << fd;
+    }
+}
+
+void EpollDispatcher::registerTimer(int timerId, Interval interval, Qt::TimerType timerType, QObject *object)
+{
+    qint64 nsecs = qint64(interval) * NsPerMs;
+    // Very coarse timers only promise whole seconds; Qt's own dispatcher rounds the same way
+    if (timerType == Qt::VeryCoarseTimer) nsecs = qMax<qint64>(1000, (qint64(interval) + 500) / 1000 * 1000) * NsPerMs;
+
+    Timer &timer = m_timers[timerId];
+    timer = Timer{object, nsecs, now() + nsecs, timerType, 0, false};
+    m_timersByObject.insert(object, timerId);
+    schedule(timerId, timer);
+    if (m_armed < 0 || timer.deadline < m_armed) arm();
+}
+
+bool EpollDispatcher::unregisterTimer(int timerId)
+{
+    auto it = m_timers.find(timerId);
+    if (it == m_timers.end()) return false;
+    m_timersByObject.remove(it->object, timerId);
+    m_timers.erase(it);
+    // The heap entry goes stale and is skipped when it reaches the top
+    if (m_heap.size() > 2 * size_t(m_timers.size()) + 64) compact();
+    return true;
+}
+
+bool EpollDispatcher::unregisterTimers(QObject *object)
+{
+    const QList<int> ids = m_timersByObject.values(object);
+    if (ids.isEmpty()) return false;
+    for (int id : ids) m_timers.remove(id);
+    m_timersByObject.remove(object);
+    if (m_heap.size() > 2 * size_t(m_timers.size()) + 64) compact();
+    return true;
+}
+
+QList<QAbstractEventDispatcher::TimerInfo> EpollDispatcher::registeredTimers(QObject *object) const
+{
+    QList<TimerInfo> list;
+    for (auto it = m_timersByObject.constFind(object); it != m_timersByObject.cend() && it.key() == object; ++it) {
+        const Timer &timer = m_timers[it.value()];
+        list.append(TimerInfo(it.value(), int(timer.interval / NsPerMs), timer.type));
+    }
+    return list;
+}
+
+int EpollDispatcher::remainingTime(int timerId)
+{
+    auto it = m_timers.constFind(timerId);
+    if (it == m_timers.cend()) return -1;
+    return int(qMax<qint64>(0, it->deadline - now()) / NsPerMs);
+}
+
+void EpollDispatcher::wakeUp()
+{
+    const quint64 one = 1;
+    if (write(m_wake, &one, sizeof one) < 0) {} // Already signalled
+}
+
+void EpollDispatcher::interrupt()
+{
+    m_interrupted = true;
+    wakeUp();
+}
+
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+bool EpollDispatcher::hasPendingEvents()
+{
+    return qGlobalPostedEventsCount() > 0;
+}
+
+void EpollDispatcher::flush()
+{
+}
+#endif
+
+void EpollDispatcher::schedule(int timerId, Timer &timer)
+{
+    m_heap.push_back({timer.deadline, timerId, timer.serial});
+    std::push_heap(m_heap.begin(), m_heap.end(), std::greater<Deadline>());
+}
+
+void EpollDispatcher::arm()
+{
+    // Drop killed or rescheduled timers sitting on top
+    while (!m_heap.empty()) {
+        const Deadline &top = m_heap.front();
+        auto it = m_timers.constFind(top.timerId);
+        if (it != m_timers.cend() && it->serial == top.serial) break;
+        std::pop_heap(m_heap.begin(), m_heap.end(), std::greater<Deadline>());
+        m_heap.pop_back();
+    }
+
+    itimerspec spec = {};
+    if (!m_heap.empty()) {
+        const qint64 when = qMax<qint64>(1, m_heap.front().when); // Zero would disarm
+        spec.it_value.tv_sec = time_t(when / 1000000000);
+        spec.it_value.tv_nsec = long(when % 1000000000);
+        m_armed = when;
+    } else {
+        m_armed = -1;
+    }
+    timerfd_settime(m_timerfd, TFD_TIMER_ABSTIME, &spec, nullptr);
+}
+
+void EpollDispatcher::compact()
+{
+    m_heap.clear();
+    m_heap.reserve(size_t(m_timers.size()));
+    for (auto it = m_timers.cbegin(); it != m_timers.cend(); ++it) m_heap.push_back({it->deadline, it.key(), it->serial});
+    std::make_heap(m_heap.begin(), m_heap.end(), std::greater<Deadline>());
+}
+
+int EpollDispatcher::fireTimers()
+{
+    const qint64 start = now();
+
+    // Take everything due first so zero-interval timers fire once per pass, not forever
+    QVector<int> due;
+    while (!m_heap.empty() && m_heap.front().when <= start) {
+        const Deadline top = m_heap.front();
+        std::pop_heap(m_heap.begin(), m_heap.end(), std::greater<Deadline>());
+        m_heap.pop_back();
+
+        auto it = m_timers.find(top.timerId);
+        if (it == m_timers.end() || it->serial != top.serial) continue;
+
+        // Skip missed periods rather than firing a burst to catch up; a zero interval
+        // still lands after start, so the next pass is the earliest it fires again
+        it->deadline += it->interval;
+        if (it->deadline <= start) it->deadline = start + qMax<qint64>(1, it->interval);
+        it->serial++;
+        due.append(top.timerId);
+    }
+
+    // Back on the heap only once the due ones are all off it
+    for (int timerId : due) schedule(timerId, m_timers[timerId]);
+
+    int fired = 0;
+    for (int timerId : due) {
+        auto it = m_timers.find(timerId);
+        // Killed by an earlier handler, or still inside its own timerEvent
+        if (it == m_timers.end() || it->active) continue;
+
+        QObject *object = it->object;
+        it->active = true;
+        QTimerEvent event(timerId);
+        QCoreApplication::sendEvent(object, &event);
+        fired++;
+
+        it = m_timers.find(timerId);
+        if (it != m_timers.end()) it->active = false;
+    }
+
+    arm();
+    return fired;
+}
@@ -0,0 +1,96 @@
+#ifndef EPOLLDISPATCHER_H
+#define EPOLLDISPATCHER_H
+
+#include <QAbstractEventDispatcher>
+#include <QHash>
+#include <QMultiHash>
+#include <atomic>
+#include <vector>
+
+// Linux-only event dispatcher: one epoll set for socket notifiers, an eventfd for
+// wake-ups and a single timerfd armed to the earliest deadline of a min-heap of
+// timers. Registering, killing and firing a timer are O(log n) instead of a scan
+// of every timer on each loop iteration.
+//
+// Install it before the application or thread starts running:
+//     QCoreApplication::setEventDispatcher(new EpollDispatcher);
+//     thread->setEventDispatcher(new EpollDispatcher);
+class EpollDispatcher : public QAbstractEventDispatcher
+{
+    Q_OBJECT
+public:
+    explicit EpollDispatcher(QObject *parent = nullptr);
+    ~EpollDispatcher();
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    using Interval = qint64;
+#else
+    using Interval = int;
+#endif
+
+    bool processEvents(QEventLoop::ProcessEventsFlags flags) override;
+
+    void registerSocketNotifier(QSocketNotifier *notifier) override;
+    void unregisterSocketNotifier(QSocketNotifier *notifier) override;
+
+    void registerTimer(int timerId, Interval interval, Qt::TimerType timerType, QObject *object) override;
+    bool unregisterTimer(int timerId) override;
+    bool unregisterTimers(QObject *object) override;
+    QList<TimerInfo> registeredTimers(QObject *object) const override;
+    int remainingTime(int timerId) override;
+
+    void wakeUp() override;
+    void interrupt() override;
+
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    bool hasPendingEvents() override;
+    void flush() override;
+#endif
+
+private:
+    struct Timer
+    {
+        QObject *object;
+        qint64 interval; // Nanoseconds
+        qint64 deadline;
+        Qt::TimerType type;
+        quint32 serial;
+        bool active;
+    };
+
+    struct Deadline
+    {
+        qint64 when;
+        int timerId;
+        quint32 serial;
+        bool operator>(const Deadline &other) const { return when > other.when; }
+    };
+
+    struct Notifiers
+    {
+        QSocketNotifier *read = nullptr;
+        QSocketNotifier *write = nullptr;
+        QSocketNotifier *exception = nullptr;
+    };
+
+    static qint64 now();
+    void schedule(int timerId, Timer &timer);
+    void arm();
+    void compact();
+    int fireTimers();
+    void updateEpoll(int fd, const Notifiers &notifiers, bool existed);
+
+    int m_epoll = -1;
+    int m_wake = -1;
+    int m_timerfd = -1;
+    qint64 m_armed = -1;
+
+    QHash<int, Timer> m_timers;
+    QMultiHash<QObject *, int> m_timersByObject;
+    std::vector<Deadline> m_heap;
+
+    QHash<int, Notifiers> m_notifiers;
+    std::atomic<bool> m_interrupted{false};
+};
+
+#endif // EPOLLDISPATCHER_H
@@ -3,5 +3,6 @@
 Feline::Feline(QObject *parent)
     : Mammal{parent}
 {
-    qInfo() << this << "Constructed";
+    m_type = FelineType;
+    if (!quiet) qInfo() << this << "Constructed";
 }
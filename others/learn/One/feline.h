@@ -11,6 +11,9 @@ class Feline : public Mammal
 public:
     explicit Feline(QObject *parent = nullptr);
 
+    static constexpr quint8 TypeFirst = FelineType;
+    static constexpr quint8 TypeLast = FelineType;
+
     void meow() {
         qInfo() << "MEOW!";
     }
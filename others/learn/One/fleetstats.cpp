@@ -0,0 +1,185 @@
+#include "fleetstats.h"
+#include <QThread>
+#include <vector>
+#include "laptopfleet.h"
+
+#if defined(__SSE2__)
+#define FLEET_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#define FLEET_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+constexpr double KilosPerPound = 0.453592; // Same as Laptop::asKilo()
+
+} // namespace
+
+double FleetSummary::totalKilos() const
+{
+    return totalPounds * KilosPerPound;
+}
+
+double FleetSummary::meanKilos() const
+{
+    return count ? double(totalPounds) / double(count) * KilosPerPound : 0.0;
+}
+
+double FleetSummary::minKilos() const
+{
+    return count ? minPounds * KilosPerPound : 0.0;
+}
+
+double FleetSummary::maxKilos() const
+{
+    return count ? maxPounds * KilosPerPound : 0.0;
+}
+
+void FleetSummary::merge(const FleetSummary &other)
+{
+    count += other.count;
+    totalPounds += other.totalPounds;
+    minPounds = qMin(minPounds, other.minPounds);
+    maxPounds = qMax(maxPounds, other.maxPounds);
+}
+
+FleetStats::FleetStats(int threads)
+    : m_threads(threads > 0 ? threads : qMax(1, QThread::idealThreadCount()))
+{}
+
+void FleetStats::setBuckets(int width, int count)
+{
+    m_bucketWidth = qMax(1, width);
+    m_bucketCount = qMax(1, count);
+}
+
+FleetSummary FleetStats::reduce(const qint32 *weights, qint64 count)
+{
+    FleetSummary summary;
+    summary.count = count;
+    qint64 i = 0;
+
+#if defined(FLEET_SSE2)
+    if (count >= 4) {
+        __m128i sumLow = _mm_setzero_si128();
+        __m128i sumHigh = _mm_setzero_si128();
+        __m128i low = _mm_set1_epi32(summary.minPounds);
+        __m128i high = _mm_set1_epi32(summary.maxPounds);
+        for (; i + 4 <= count; i += 4) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(weights + i));
+            // Sign-extend to 64 bits so the sums can never wrap
+            const __m128i sign = _mm_srai_epi32(v, 31);
+            sumLow = _mm_add_epi64(sumLow, _mm_unpacklo_epi32(v, sign));
+            sumHigh = _mm_add_epi64(sumHigh, _mm_unpackhi_epi32(v, sign));
+            // SSE2 has no 32-bit min/max, so select with a compare mask
+            const __m128i less = _mm_cmplt_epi32(v, low);
+            low = _mm_or_si128(_mm_and_si128(less, v), _mm_andnot_si128(less, low));
+            const __m128i greater = _mm_cmpgt_epi32(v, high);
+            high = _mm_or_si128(_mm_and_si128(greater, v), _mm_andnot_si128(greater, high));
+        }
+        qint64 sums[2];
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(sums), _mm_add_epi64(sumLow, sumHigh));
+        summary.totalPounds = sums[0] + sums[1];
+        qint32 lows[4];
+        qint32 highs[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(lows), low);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(highs), high);
+        for (int lane = 0; lane < 4; lane++) {
+            summary.minPounds = qMin(summary.minPounds, lows[lane]);
+            summary.maxPounds = qMax(summary.maxPounds, highs[lane]);
+        }
+    }
+#elif defined(FLEET_NEON)
+    if (count >= 4) {
+        int64x2_t sum = vdupq_n_s64(0);
+        int32x4_t low = vdupq_n_s32(summary.minPounds);
+        int32x4_t high = vdupq_n_s32(summary.maxPounds);
+        for (; i + 4 <= count; i += 4) {
+            const int32x4_t v = vld1q_s32(weights + i);
+            sum = vpadalq_s32(sum, v); // Pairwise widening add, never wraps
+            low = vminq_s32(low, v);
+            high = vmaxq_s32(high, v);
+        }
+        summary.totalPounds = vgetq_lane_s64(sum, 0) + vgetq_lane_s64(sum, 1);
+        // Pairwise folds rather than vminvq/vmaxvq, which only AArch64 has
+        int32x2_t lowPair = vpmin_s32(vget_low_s32(low), vget_high_s32(low));
+        int32x2_t highPair = vpmax_s32(vget_low_s32(high), vget_high_s32(high));
+        summary.minPounds = vget_lane_s32(vpmin_s32(lowPair, lowPair), 0);
+        summary.maxPounds = vget_lane_s32(vpmax_s32(highPair, highPair), 0);
+    }
+#endif
+
+    for (; i < count; i++) {
+        summary.totalPounds += weights[i];
+        summary.minPounds = qMin(summary.minPounds, weights[i]);
+        summary.maxPounds = qMax(summary.maxPounds, weights[i]);
+    }
+    return summary;
+}
+
+template <typename Work>
+void FleetStats::parallel(qint64 count, Work &&work) const
+{
+    // Small inputs are not worth a thread
+    const int slices = int(qBound<qint64>(1, count / 65536, m_threads));
+    std::vector<QThread *> threads;
+    for (int slice = 1; slice < slices; slice++) {
+        const qint64 begin = count * slice / slices;
+        const qint64 end = count * (slice + 1) / slices;
+        threads.push_back(QThread::create([&work, slice, begin, end] { work(slice, begin, end); }));
+        threads.back()->start();
+    }
+    work(0, 0, count / slices);
+    for (QThread *thread : threads) {
+        thread->wait();
+        delete thread;
+    }
+}
+
+FleetSummary FleetStats::summarize(const LaptopFleet &fleet) const
+{
+    return summarize(fleet.weights(), fleet.size());
+}
+
+FleetSummary FleetStats::summarize(const qint32 *weights, qint64 count) const
+{
+    std::vector<FleetSummary> partial(size_t(m_threads));
+    parallel(count, [&partial, weights](int slice, qint64 begin, qint64 end) {
+        partial[size_t(slice)] = reduce(weights + begin, end - begin);
+    });
+
+    FleetSummary summary;
+    for (const FleetSummary &part : partial) summary.merge(part);
+    return summary;
+}
+
+QVector<QVector<quint64>> FleetStats::histograms(const LaptopFleet &fleet) const
+{
+    const int groups = fleet.groupNames().size();
+    const size_t table = size_t(groups) * size_t(m_bucketCount);
+    std::vector<std::vector<quint64>> partial(size_t(m_threads));
+
+    const qint32 *weights = fleet.weights();
+    const quint32 *ids = fleet.groups();
+    const int width = m_bucketWidth;
+    const int last = m_bucketCount - 1;
+    parallel(fleet.size(), [&, table](int slice, qint64 begin, qint64 end) {
+        std::vector<quint64> &counts = partial[size_t(slice)];
+        counts.assign(table, 0);
+        for (qint64 i = begin; i < end; i++) {
+            const int bucket = weights[i] <= 0 ? 0 : qMin(weights[i] / width, last);
+            counts[size_t(ids[i]) * size_t(last + 1) + size_t(bucket)]++;
+        }
+    });
+
+    QVector<QVector<quint64>> result(groups, QVector<quint64>(m_bucketCount, 0));
+    for (const std::vector<quint64> &counts : partial) {
+        if (counts.empty()) continue;
+        for (int group = 0; group < groups; group++) {
+            for (int bucket = 0; bucket <= last; bucket++) result[group][bucket] += counts[size_t(group) * size_t(last + 1) + size_t(bucket)];
+        }
+    }
+    return result;
+}
@@ -0,0 +1,56 @@
+#ifndef FLEETSTATS_H
+#define FLEETSTATS_H
+
+#include <QVector>
+#include <limits>
+
+class LaptopFleet;
+
+struct FleetSummary
+{
+    qint64 count = 0;
+    qint64 totalPounds = 0;
+    qint32 minPounds = std::numeric_limits<qint32>::max();
+    qint32 maxPounds = std::numeric_limits<qint32>::min();
+
+    // Converted once at the end with Laptop::asKilo()'s factor
+    double totalKilos() const;
+    double meanKilos() const;
+    double minKilos() const;
+    double maxKilos() const;
+
+    void merge(const FleetSummary &other);
+};
+
+// Fleet-wide weight statistics. Each thread reduces its own slice of the weight
+// column with SSE2 or NEON, and the partial results are merged. All the
+// arithmetic is on integer pounds, so the result is identical whatever the thread
+// count or partitioning; only the final kilogram conversion uses floating point.
+class FleetStats
+{
+public:
+    explicit FleetStats(int threads = 0); // 0 means QThread::idealThreadCount()
+
+    // Histogram buckets in pounds; the last bucket also takes everything heavier
+    void setBuckets(int width, int count);
+
+    FleetSummary summarize(const LaptopFleet &fleet) const;
+    FleetSummary summarize(const qint32 *weights, qint64 count) const;
+
+    // One row per group (see LaptopFleet::groupNames()), one count per bucket.
+    // Every thread keeps its own groups x buckets table, so keep groups few.
+    QVector<QVector<quint64>> histograms(const LaptopFleet &fleet) const;
+
+    // The single-core kernel
+    static FleetSummary reduce(const qint32 *weights, qint64 count);
+
+private:
+    template <typename Work>
+    void parallel(qint64 count, Work &&work) const;
+
+    int m_threads;
+    int m_bucketWidth = 1;
+    int m_bucketCount = 16;
+};
+
+#endif // FLEETSTATS_H
@@ -0,0 +1,317 @@
+#include "journal.h"
+#include <QDir>
+#include <QFileInfo>
+#include <chrono>
+#include <climits>
+
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using namespace JournalFormat;
+
+namespace {
+
+quint64 firstSequenceOf(const QString &path)
+{
+    return QFileInfo(path).completeBaseName().toULongLong();
+}
+
+void syncRange(uchar *base, qint64 from, qint64 to)
+{
+    if (to <= from) return;
+#ifdef Q_OS_UNIX
+    const qint64 page = sysconf(_SC_PAGESIZE);
+    qint64 start = from - from % page;
+    msync(base + start, size_t(to - start), MS_SYNC);
+#else
+    Q_UNUSED(base);
+#endif
+}
+
+void syncDirectory(const QString &directory)
+{
+#ifdef Q_OS_UNIX
+    int fd = ::open(QFile::encodeName(directory).constData(), O_RDONLY);
+    if (fd >= 0) {
+        ::fsync(fd);
+        ::close(fd);
+    }
+#else
+    Q_UNUSED(directory);
+#endif
+}
+
+} // namespace
+
+Journal::Journal(const QString &directory, QObject *parent)
+    : QObject{parent}, m_directory{directory}
+{}
+
+Journal::~Journal()
+{
+    close();
+}
+
+void Journal::setSegmentSize(qint64 bytes)
+{
+    m_segmentSize = qMax<qint64>(bytes, 4096);
+}
+
+void Journal::setFlushInterval(int msecs)
+{
+    m_flushInterval = qMax(1, msecs);
+}
+
+bool Journal::open()
+{
+    if (isOpen()) return true;
+    if (!QDir().mkpath(m_directory)) {
+        qWarning() << "Journal: can not create" << m_directory;
+        return false;
+    }
+
+    QStringList files = segmentFiles();
+    QString last = files.isEmpty() ? QString() : files.takeLast();
+
+    m_recovered = 0;
+    for (const QString &path : files) {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) continue;
+        if (uchar *data = file.map(0, file.size())) {
+            scan(data, file.size(), [this](const Record &) { m_recovered++; });
+        }
+    }
+
+    if (last.isEmpty()) last = QDir(m_directory).filePath(QString("%1.seg").arg(1, 20, 10, QChar('0')));
+    if (!openSegment(last, firstSequenceOf(last))) return false;
+
+    m_durable = m_nextSequence - 1;
+    m_running = true;
+    m_flusher = QThread::create([this] { flushLoop(); });
+    m_flusher->start();
+    return true;
+}
+
+bool Journal::openSegment(const QString &path, quint64 firstSequence)
+{
+    QFile *file = new QFile(path);
+    bool created = !file->exists();
+    if (!file->open(QIODevice::ReadWrite) || (file->size() < m_segmentSize && !file->resize(m_segmentSize))) {
+        qWarning() << "Journal: can not open" << path << file->errorString();
+        delete file;
+        return false;
+    }
+
+    uchar *base = file->map(0, file->size());
+    if (!base) {
+        qWarning() << "Journal: can not map" << path << file->errorString();
+        delete file;
+        return false;
+    }
+
+    // Never rewrite a segment some other version of the format left behind
+    SegmentHeader existing;
+    memcpy(&existing, base, sizeof(existing));
+    if (existing.magic == Magic && existing.version != Version) {
+        qWarning() << "Journal:" << path << "has format version" << existing.version << "not" << Version;
+        file->unmap(base);
+        delete file;
+        return false;
+    }
+
+    quint64 records = 0;
+    qint64 tail = scan(base, file->size(), [&records](const Record &) { records++; });
+    if (tail == 0) {
+        SegmentHeader header{Magic, Version, firstSequence, {}};
+        memcpy(base, &header, sizeof(header));
+        tail = sizeof(header);
+    }
+
+    // A torn record past the tail must not resurface once newer records end on its boundary
+    if (tail + qint64(sizeof(quint32)) <= file->size()) {
+        quint32 next;
+        memcpy(&next, base + tail, sizeof(next));
+        if (next != 0) memset(base + tail, 0, size_t(file->size() - tail));
+    }
+
+    if (created) syncDirectory(m_directory);
+
+    m_current = Segment{file, base, 0, tail};
+    m_recovered += records;
+    m_nextSequence = firstSequence + records;
+    return true;
+}
+
+bool Journal::roll()
+{
+    m_retired.append(m_current);
+    m_current = Segment{nullptr, nullptr, 0, 0};
+
+    QString path = QDir(m_directory).filePath(QString("%1.seg").arg(m_nextSequence, 20, 10, QChar('0')));
+    quint64 recovered = m_recovered;
+    bool opened = openSegment(path, m_nextSequence);
+    m_recovered = recovered;
+    m_flushWake.wakeOne();
+    return opened;
+}
+
+void Journal::close()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_flusher) return;
+        m_running = false;
+        m_flushWake.wakeOne();
+    }
+    m_flusher->wait();
+    delete m_flusher;
+    m_flusher = nullptr;
+
+    release(m_current);
+    m_current = Segment{nullptr, nullptr, 0, 0};
+}
+
+bool Journal::isOpen() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_current.base != nullptr;
+}
+
+quint64 Journal::append(int channel, QStringView name, QStringView message)
+{
+    const quint32 payload = quint32((name.size() + message.size()) * 2);
+    const qint64 bytes = recordSize(payload);
+    if (bytes > m_segmentSize - qint64(sizeof(SegmentHeader))) return 0;
+
+    QMutexLocker locker(&m_mutex);
+    if (!m_current.base) return 0;
+
+    // Read under the lock so timestamps never run backwards along the sequence
+    const qint64 timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    if (m_current.end + bytes > m_segmentSize && !roll()) return 0;
+
+    uchar *at = m_current.base + m_current.end;
+    uchar *text = at + sizeof(RecordHeader);
+    memcpy(text, name.data(), size_t(name.size()) * 2);
+    memcpy(text + name.size() * 2, message.data(), size_t(message.size()) * 2);
+
+    RecordHeader header{encodedSize(payload), 0, timestamp, channel, quint32(name.size())};
+    header.crc = checksum(header, text);
+    memcpy(at, &header, sizeof(header));
+
+    m_current.end += bytes;
+    return m_nextSequence++;
+}
+
+void Journal::record(int channel, QString name, QString message)
+{
+    append(channel, name, message);
+}
+
+void Journal::commit()
+{
+    QMutexLocker locker(&m_mutex);
+    m_commitRequested = true;
+    m_flushWake.wakeOne();
+}
+
+bool Journal::waitForDurable(quint64 sequence, unsigned long msecs)
+{
+    QMutexLocker locker(&m_mutex);
+    while (m_durable < sequence) {
+        if (!m_running) return false;
+        m_commitRequested = true;
+        m_flushWake.wakeOne();
+        if (!m_durableWake.wait(&m_mutex, msecs)) return m_durable >= sequence;
+    }
+    return true;
+}
+
+quint64 Journal::lastSequence() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_nextSequence - 1;
+}
+
+quint64 Journal::durableSequence() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_durable;
+}
+
+quint64 Journal::recovered() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_recovered;
+}
+
+void Journal::flushLoop()
+{
+    QMutexLocker locker(&m_mutex);
+    bool running = true;
+    while (running) {
+        if (!m_commitRequested && m_running) m_flushWake.wait(&m_mutex, ulong(m_flushInterval));
+        running = m_running;
+        m_commitRequested = false;
+
+        // One msync covers every append since the last round: the group commit
+        QList<Segment> retired = m_retired;
+        m_retired.clear();
+        Segment current = m_current;
+        quint64 upTo = m_nextSequence - 1;
+        locker.unlock();
+
+        for (const Segment &segment : retired) release(segment);
+        syncRange(current.base, current.synced, current.end);
+
+        locker.relock();
+        if (m_current.base == current.base) m_current.synced = qMax(m_current.synced, current.end);
+        m_durable = upTo;
+        m_durableWake.wakeAll();
+    }
+}
+
+void Journal::release(const Segment &segment)
+{
+    if (!segment.file) return;
+    syncRange(segment.base, segment.synced, segment.end);
+    segment.file->unmap(segment.base);
+    delete segment.file;
+}
+
+QStringList Journal::segmentFiles() const
+{
+    QDir dir(m_directory);
+    QStringList files;
+    for (const QString &name : dir.entryList({"*.seg"}, QDir::Files, QDir::Name)) {
+        files.append(dir.filePath(name));
+    }
+    return files;
+}
+
+quint64 Journal::replay(Radio *radio, quint64 fromSequence) const
+{
+    QStringList files = segmentFiles();
+    quint64 delivered = 0;
+
+    for (int i = 0; i < files.size(); i++) {
+        if (i + 1 < files.size() && firstSequenceOf(files.at(i + 1)) <= fromSequence) continue;
+
+        QFile file(files.at(i));
+        if (!file.open(QIODevice::ReadOnly)) continue;
+        uchar *data = file.map(0, file.size());
+        if (!data) continue;
+
+        quint64 sequence = firstSequenceOf(files.at(i));
+        scan(data, file.size(), [&](const Record &record) {
+            if (sequence++ < fromSequence) return;
+            radio->listenView(record.channel, record.name, record.message);
+            delivered++;
+        });
+    }
+    return delivered;
+}
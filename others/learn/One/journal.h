@@ -0,0 +1,80 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <QObject>
+#include <QDebug>
+#include <QFile>
+#include <QList>
+#include <QMutex>
+#include <QStringList>
+#include <QStringView>
+#include <QThread>
+#include <QWaitCondition>
+#include <climits>
+#include "journalformat.h"
+#include "radio.h"
+
+// Append-only, segmented log of Station::send traffic on memory-mapped files.
+// Appends only copy into the mapping; a background thread makes them durable in
+// groups every flush interval, or sooner when someone waits for a sequence.
+class Journal : public QObject
+{
+    Q_OBJECT
+public:
+    explicit Journal(const QString &directory, QObject *parent = nullptr);
+    ~Journal();
+
+    // Both take effect on the next open()
+    void setSegmentSize(qint64 bytes);
+    void setFlushInterval(int msecs);
+
+    bool open();
+    void close();
+    bool isOpen() const;
+
+    // Returns the record's sequence number (1 based) or 0 if it could not be written
+    quint64 append(int channel, QStringView name, QStringView message);
+    void commit();
+    bool waitForDurable(quint64 sequence, unsigned long msecs = ULONG_MAX);
+
+    quint64 lastSequence() const;
+    quint64 durableSequence() const;
+    quint64 recovered() const;
+
+    QStringList segmentFiles() const;
+    quint64 replay(Radio *radio, quint64 fromSequence = 1) const;
+
+public slots:
+    void record(int channel, QString name, QString message);
+
+private:
+    struct Segment {
+        QFile *file;
+        uchar *base;
+        qint64 synced;
+        qint64 end;
+    };
+
+    bool openSegment(const QString &path, quint64 firstSequence);
+    bool roll();
+    void flushLoop();
+    void release(const Segment &segment);
+
+    QString m_directory;
+    qint64 m_segmentSize = 64 * 1024 * 1024;
+    int m_flushInterval = 2;
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_flushWake;
+    QWaitCondition m_durableWake;
+    Segment m_current{nullptr, nullptr, 0, 0};
+    QList<Segment> m_retired;
+    quint64 m_nextSequence = 1;
+    quint64 m_durable = 0;
+    quint64 m_recovered = 0;
+    bool m_commitRequested = false;
+    bool m_running = false;
+    QThread *m_flusher = nullptr;
+};
+
+#endif // JOURNAL_H
@@ -0,0 +1,99 @@
+#ifndef JOURNALFORMAT_H
+#define JOURNALFORMAT_H
+
+#include <QtGlobal>
+#include <QStringView>
+#include <cstring>
+#include "crc32c.h"
+
+// On-disk layout shared by Journal (writer) and anything that reads segments back.
+// A segment is a SegmentHeader followed by 8-byte aligned records. A record is a
+// RecordHeader followed by the name and message as raw UTF-16, so readers can
+// point QStringViews straight into the mapping. A record's size includes its own
+// header, so even an empty name and message is never zero; a zero size marks the tail.
+namespace JournalFormat {
+
+constexpr quint32 Magic = 0x4C4E524A; // "JRNL"
+constexpr quint32 Version = 2;
+
+struct SegmentHeader {
+    quint32 magic;
+    quint32 version;
+    quint64 firstSequence;
+    quint64 reserved[6];
+};
+static_assert(sizeof(SegmentHeader) == 64, "SegmentHeader must stay 64 bytes");
+
+struct RecordHeader {
+    quint32 size;       // Header plus payload bytes, not counting padding
+    quint32 crc;        // CRC32C of size, the fields below and the payload
+    qint64 timestamp;   // Nanoseconds since the epoch
+    qint32 channel;
+    quint32 nameLength; // UTF-16 code units; the rest of the payload is the message
+};
+static_assert(sizeof(RecordHeader) == 24, "RecordHeader must stay 24 bytes");
+
+struct Record {
+    qint64 timestamp;
+    int channel;
+    QStringView name;
+    QStringView message;
+};
+
+inline quint32 encodedSize(quint32 payload)
+{
+    return quint32(sizeof(RecordHeader)) + payload;
+}
+
+inline quint32 payloadSize(const RecordHeader &header)
+{
+    return header.size - quint32(sizeof(RecordHeader));
+}
+
+inline qint64 recordSize(quint32 payload)
+{
+    return (qint64(sizeof(RecordHeader)) + payload + 7) & ~qint64(7);
+}
+
+inline quint32 checksum(const RecordHeader &header, const uchar *payload)
+{
+    quint32 crc = crc32c(0, &header.size, sizeof(header.size));
+    crc = crc32c(crc, &header.timestamp, sizeof(RecordHeader) - offsetof(RecordHeader, timestamp));
+    return crc32c(crc, payload, payloadSize(header));
+}
+
+// Calls visit(const Record &) for each intact record and returns the offset just past
+// the last one, which is where a writer resumes after a crash or a torn tail.
+template<typename Visitor>
+qint64 scan(const uchar *segment, qint64 length, Visitor &&visit)
+{
+    if (length < qint64(sizeof(SegmentHeader))) return 0;
+
+    SegmentHeader header;
+    memcpy(&header, segment, sizeof(header));
+    if (header.magic != Magic || header.version != Version) return 0;
+
+    qint64 offset = sizeof(SegmentHeader);
+    while (offset + qint64(sizeof(RecordHeader)) <= length) {
+        const RecordHeader *record = reinterpret_cast<const RecordHeader *>(segment + offset);
+        if (record->size < sizeof(RecordHeader)) break;
+        const quint32 bytes = payloadSize(*record);
+        if (bytes % 2 || qint64(record->nameLength) * 2 > bytes) break;
+        if (offset + recordSize(bytes) > length) break;
+
+        const uchar *payload = segment + offset + sizeof(RecordHeader);
+        if (checksum(*record, payload) != record->crc) break;
+
+        const QChar *text = reinterpret_cast<const QChar *>(payload);
+        qsizetype total = bytes / 2;
+        visit(Record{record->timestamp, record->channel,
+                     QStringView(text, record->nameLength),
+                     QStringView(text + record->nameLength, total - record->nameLength)});
+        offset += recordSize(bytes);
+    }
+    return offset;
+}
+
+} // namespace JournalFormat
+
+#endif // JOURNALFORMAT_H
@@ -0,0 +1,98 @@
+#include "journalreplay.h"
+#include <QDir>
+#include <QElapsedTimer>
+#include <QThread>
+
+JournalReplay::JournalReplay(const QString &directory, QObject *parent)
+    : QObject{parent}, m_directory{directory}
+{}
+
+JournalReplay::~JournalReplay()
+{
+    close();
+}
+
+bool JournalReplay::open()
+{
+    close();
+
+    QDir dir(m_directory);
+    for (const QString &name : dir.entryList({"*.seg"}, QDir::Files, QDir::Name)) {
+        QFile *file = new QFile(dir.filePath(name));
+        uchar *data = file->open(QIODevice::ReadOnly) ? file->map(0, file->size()) : nullptr;
+        if (!data) {
+            qWarning() << "JournalReplay: can not map" << file->fileName() << file->errorString();
+            delete file;
+            close();
+            return false;
+        }
+        m_files.append(file);
+        m_maps.append(data);
+    }
+    return !m_files.isEmpty();
+}
+
+void JournalReplay::close()
+{
+    qDeleteAll(m_files);
+    m_files.clear();
+    m_maps.clear();
+}
+
+JournalReplay::Pace JournalReplay::pace() const
+{
+    return m_pace;
+}
+
+void JournalReplay::setPace(Pace newPace)
+{
+    m_pace = newPace;
+}
+
+double JournalReplay::speed() const
+{
+    return m_speed;
+}
+
+void JournalReplay::setSpeed(double newSpeed)
+{
+    m_speed = newSpeed > 0 ? newSpeed : 1.0;
+}
+
+qint64 JournalReplay::bytes() const
+{
+    qint64 total = 0;
+    for (const QFile *file : m_files) total += file->size();
+    return total;
+}
+
+quint64 JournalReplay::replay(Radio *radio)
+{
+    const double speed = m_pace == Scaled ? m_speed : 1.0;
+    quint64 delivered = 0;
+    qint64 first = 0;
+    QElapsedTimer clock;
+
+    for (int i = 0; i < m_files.size(); i++) {
+        JournalFormat::scan(m_maps.at(i), m_files.at(i)->size(), [&](const JournalFormat::Record &record) {
+            if (m_pace != AsFastAsPossible) {
+                if (!clock.isValid()) {
+                    first = record.timestamp;
+                    clock.start();
+                }
+                waitUntil(qint64((record.timestamp - first) / speed), clock);
+            }
+            radio->listenView(record.channel, record.name, record.message);
+            delivered++;
+        });
+    }
+    return delivered;
+}
+
+void JournalReplay::waitUntil(qint64 nsecs, const QElapsedTimer &clock) const
+{
+    // Sleep off the bulk of long gaps, spin the last stretch so short gaps stay accurate
+    qint64 remaining = nsecs - clock.nsecsElapsed();
+    if (remaining > 2000000) QThread::usleep(ulong((remaining - 1000000) / 1000));
+    while (clock.nsecsElapsed() < nsecs) QThread::yieldCurrentThread();
+}
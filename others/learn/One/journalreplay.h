@@ -0,0 +1,50 @@
+#ifndef JOURNALREPLAY_H
+#define JOURNALREPLAY_H
+
+#include <QObject>
+#include <QDebug>
+#include <QFile>
+#include <QList>
+#include "journalformat.h"
+#include "radio.h"
+
+class QElapsedTimer;
+
+// Feeds a recorded Journal back into Radio::listenView for load testing. Segments
+// are mapped read-only and names/messages are passed as views into the mapping.
+class JournalReplay : public QObject
+{
+    Q_OBJECT
+public:
+    enum Pace {
+        OriginalTiming,     // Same gaps between records as when they were recorded
+        Scaled,             // Original gaps divided by speed()
+        AsFastAsPossible
+    };
+    Q_ENUM(Pace)
+
+    explicit JournalReplay(const QString &directory, QObject *parent = nullptr);
+    ~JournalReplay();
+
+    bool open();
+    void close();
+
+    Pace pace() const;
+    void setPace(Pace newPace);
+    double speed() const;
+    void setSpeed(double newSpeed);
+
+    qint64 bytes() const;
+    quint64 replay(Radio *radio);
+
+private:
+    void waitUntil(qint64 nsecs, const QElapsedTimer &clock) const;
+
+    QString m_directory;
+    Pace m_pace = AsFastAsPossible;
+    double m_speed = 1.0;
+    QList<QFile *> m_files;
+    QList<const uchar *> m_maps;
+};
+
+#endif // JOURNALREPLAY_H
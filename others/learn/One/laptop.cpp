@@ -4,12 +4,12 @@ Laptop::Laptop(QObject *parent, QString name)
     : QObject{parent}
 {
     this->name = name;
-    qInfo() << this << "Constructor" << name;
+    if (!quiet) qInfo() << this << "Constructor" << name;
 }
 
 Laptop::~Laptop()
 {
-    qInfo() << this << "Deconstructor" << name;
+    if (!quiet) qInfo() << this << "Deconstructor" << name;
 }
 
 double Laptop::asKilo()
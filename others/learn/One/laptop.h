@@ -3,6 +3,7 @@
 
 #include <QObject>
 #include <QDebug>
+#include <atomic>
 
 class Laptop : public QObject
 {
@@ -15,6 +16,11 @@ public:
 
     int weight;
     QString name;
+
+    // Silences the constructor and destructor messages. Atomic like Animal::quiet,
+    // since whichever thread creates or deletes a laptop reads it.
+    static std::atomic<bool> quiet;
+
     double asKilo();
     void test();
 
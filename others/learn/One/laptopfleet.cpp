@@ -0,0 +1,95 @@
+#include "laptopfleet.h"
+#include "laptop.h"
+#include <QDebug>
+
+LaptopFleet::LaptopFleet(int prefixLength)
+    : m_prefixLength(prefixLength)
+{}
+
+void LaptopFleet::add(const QString &name, int weight)
+{
+    m_weights.append(weight);
+    m_groups.append(groupOf(name));
+}
+
+bool LaptopFleet::add(quint32 group, int weight)
+{
+    // FleetStats indexes its per-group tables with these ids unchecked
+    if (group >= quint32(m_groupNames.size())) {
+        qWarning() << "LaptopFleet: unknown group" << group;
+        return false;
+    }
+    m_weights.append(weight);
+    m_groups.append(group);
+    return true;
+}
+
+void LaptopFleet::add(const Laptop *laptop)
+{
+    add(laptop->name, laptop->weight);
+}
+
+void LaptopFleet::addChildren(const QObject *root)
+{
+    for (const QObject *child : root->children()) {
+        if (const Laptop *laptop = qobject_cast<const Laptop *>(child)) add(laptop);
+        addChildren(child);
+    }
+}
+
+void LaptopFleet::reserve(int size)
+{
+    m_weights.reserve(size);
+    m_groups.reserve(size);
+}
+
+void LaptopFleet::clear()
+{
+    m_weights.clear();
+    m_groups.clear();
+    m_groupIds.clear();
+    m_groupNames.clear();
+}
+
+int LaptopFleet::size() const
+{
+    return m_weights.size();
+}
+
+const qint32 *LaptopFleet::weights() const
+{
+    return m_weights.constData();
+}
+
+const quint32 *LaptopFleet::groups() const
+{
+    return m_groups.constData();
+}
+
+const QStringList &LaptopFleet::groupNames() const
+{
+    return m_groupNames;
+}
+
+quint32 LaptopFleet::groupOf(const QString &name)
+{
+    QString prefix;
+    if (m_prefixLength > 0) {
+        prefix = name.left(m_prefixLength);
+    } else {
+        const int space = name.indexOf(' ');
+        prefix = space < 0 ? name : name.left(space);
+    }
+    return addGroup(prefix);
+}
+
+quint32 LaptopFleet::addGroup(const QString &prefix)
+{
+    auto it = m_groupIds.constFind(prefix);
+    if (it != m_groupIds.cend()) return it.value();
+
+    const quint32 id = quint32(m_groupNames.size());
+    m_groupIds.insert(prefix, id);
+    m_groupNames.append(prefix);
+    return id;
+}
@@ -0,0 +1,43 @@
+#ifndef LAPTOPFLEET_H
+#define LAPTOPFLEET_H
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class QObject;
+class Laptop;
+
+// Laptop weights (in pounds, as Laptop keeps them) in one column and the group of
+// each laptop in another. A laptop's group is its name prefix: the first
+// prefixLength characters, or everything before the first space when it is 0.
+class LaptopFleet
+{
+public:
+    explicit LaptopFleet(int prefixLength = 0);
+
+    void add(const QString &name, int weight);
+    bool add(quint32 group, int weight); // False for a group addGroup() never returned
+    quint32 addGroup(const QString &prefix); // Id of the group, creating it when new
+    void add(const Laptop *laptop);
+    void addChildren(const QObject *root);
+    void reserve(int size);
+    void clear();
+
+    int size() const;
+    const qint32 *weights() const;
+    const quint32 *groups() const;
+    const QStringList &groupNames() const;
+
+private:
+    quint32 groupOf(const QString &name);
+
+    int m_prefixLength;
+    QVector<qint32> m_weights;
+    QVector<quint32> m_groups;
+    QHash<QString, quint32> m_groupIds;
+    QStringList m_groupNames;
+};
+
+#endif // LAPTOPFLEET_H
@@ -0,0 +1,67 @@
+#include "latencyhistogram.h"
+
+void LatencyHistogram::record(qint64 nsecs)
+{
+    const quint64 usecs = quint64(qMax<qint64>(0, nsecs) / 1000);
+    int bucket = 0;
+    while (bucket < Buckets - 1 && (quint64(1) << bucket) <= usecs) bucket++;
+
+    m_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(nsecs, std::memory_order_relaxed);
+
+    qint64 seen = m_max.load(std::memory_order_relaxed);
+    while (seen < nsecs && !m_max.compare_exchange_weak(seen, nsecs, std::memory_order_relaxed)) {}
+}
+
+void LatencyHistogram::reset()
+{
+    for (std::atomic<quint64> &bucket : m_buckets) bucket.store(0, std::memory_order_relaxed);
+    m_count.store(0, std::memory_order_relaxed);
+    m_sum.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+quint64 LatencyHistogram::count() const
+{
+    return m_count.load(std::memory_order_relaxed);
+}
+
+qint64 LatencyHistogram::max() const
+{
+    return m_max.load(std::memory_order_relaxed);
+}
+
+qint64 LatencyHistogram::mean() const
+{
+    const quint64 total = count();
+    return total ? m_sum.load(std::memory_order_relaxed) / qint64(total) : 0;
+}
+
+qint64 LatencyHistogram::percentile(double fraction) const
+{
+    const quint64 total = count();
+    if (total == 0) return 0;
+
+    const quint64 wanted = quint64(fraction * double(total));
+    quint64 seen = 0;
+    for (int bucket = 0; bucket < Buckets; bucket++) {
+        seen += m_buckets[bucket].load(std::memory_order_relaxed);
+        if (seen > wanted) return qint64(1) << bucket;
+    }
+    return qint64(1) << (Buckets - 1);
+}
+
+QStringList LatencyHistogram::dump(const QString &title) const
+{
+    QStringList lines;
+    lines << QString("%1: %2 samples, mean %3 us, p50 <%4 us, p99 <%5 us, max %6 us")
+                 .arg(title).arg(count()).arg(mean() / 1000).arg(percentile(0.5))
+                 .arg(percentile(0.99)).arg(max() / 1000);
+
+    for (int bucket = 0; bucket < Buckets; bucket++) {
+        const quint64 samples = m_buckets[bucket].load(std::memory_order_relaxed);
+        if (samples) lines << QString("  < %1 us: %2").arg(qint64(1) << bucket).arg(samples);
+    }
+    return lines;
+}
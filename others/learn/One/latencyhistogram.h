@@ -0,0 +1,35 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <QtGlobal>
+#include <QStringList>
+#include <atomic>
+
+// Power-of-two buckets of microseconds, safe to record into from any thread.
+class LatencyHistogram
+{
+public:
+    static constexpr int Buckets = 32;
+
+    LatencyHistogram() = default;
+    LatencyHistogram(const LatencyHistogram &) = delete;
+    LatencyHistogram &operator=(const LatencyHistogram &) = delete;
+
+    void record(qint64 nsecs);
+    void reset();
+
+    quint64 count() const;
+    qint64 max() const;
+    qint64 mean() const;
+    qint64 percentile(double fraction) const; // Upper bound of the bucket, in microseconds
+
+    QStringList dump(const QString &title) const;
+
+private:
+    std::atomic<quint64> m_buckets[Buckets] = {};
+    std::atomic<quint64> m_count{0};
+    std::atomic<qint64> m_sum{0};
+    std::atomic<qint64> m_max{0};
+};
+
+#endif // LATENCYHISTOGRAM_H
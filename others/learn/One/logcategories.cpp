@@ -0,0 +1,6 @@
+#include "logcategories.h"
+
+GATED_LOGGING_CATEGORY(lcRadio, "one.radio")
+GATED_LOGGING_CATEGORY(lcWatcher, "one.watcher")
+GATED_LOGGING_CATEGORY(lcDestination, "one.destination")
+GATED_LOGGING_CATEGORY(lcTimer, "one.timer")
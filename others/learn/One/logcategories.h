@@ -0,0 +1,31 @@
+#ifndef LOGCATEGORIES_H
+#define LOGCATEGORIES_H
+
+#include <QLoggingCategory>
+#include "loggate.h"
+
+// A logging category paired with a LogGate named <category>Gate
+#define DECLARE_GATED_LOGGING_CATEGORY(name) \
+    Q_DECLARE_LOGGING_CATEGORY(name) \
+    extern LogGate name##Gate;
+
+#define GATED_LOGGING_CATEGORY(name, id) \
+    Q_LOGGING_CATEGORY(name, id, QtInfoMsg) \
+    LogGate name##Gate;
+
+// Like qCInfo(), but a message also has to get through the category's gate. When the
+// category is disabled this is one load and one branch; nothing else is evaluated.
+#ifndef QT_NO_INFO_OUTPUT
+#define qCInfoGated(category) \
+    for (bool gatedEnabled = category().isInfoEnabled() && category##Gate.admit(); gatedEnabled; gatedEnabled = false) \
+        QMessageLogger(QT_MESSAGELOG_FILE, QT_MESSAGELOG_LINE, QT_MESSAGELOG_FUNC, category().categoryName()).info()
+#else
+#define qCInfoGated(category) QT_NO_QDEBUG_MACRO()
+#endif
+
+DECLARE_GATED_LOGGING_CATEGORY(lcRadio)
+DECLARE_GATED_LOGGING_CATEGORY(lcWatcher)
+DECLARE_GATED_LOGGING_CATEGORY(lcDestination)
+DECLARE_GATED_LOGGING_CATEGORY(lcTimer)
+
+#endif // LOGCATEGORIES_H
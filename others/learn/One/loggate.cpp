@@ -0,0 +1,50 @@
+#include "loggate.h"
+#include <chrono>
+
+void LogGate::setRate(double perSecond, int burst)
+{
+    const qint64 interval = perSecond > 0 ? qMax<qint64>(1, qint64(1e9 / perSecond)) : 0;
+    m_tolerance.store(interval * qMax(0, burst - 1), std::memory_order_relaxed);
+    m_nextFree.store(0, std::memory_order_relaxed);
+    m_interval.store(interval, std::memory_order_relaxed);
+}
+
+void LogGate::setSampling(int everyNth)
+{
+    m_sampling.store(quint32(qMax(1, everyNth)), std::memory_order_relaxed);
+}
+
+bool LogGate::admit()
+{
+    const quint32 sampling = m_sampling.load(std::memory_order_relaxed);
+    bool pass = sampling == 1 || m_seen.fetch_add(1, std::memory_order_relaxed) % sampling == 0;
+    if (pass && m_interval.load(std::memory_order_relaxed) > 0) pass = limit();
+
+    (pass ? m_admitted : m_suppressed).fetch_add(1, std::memory_order_relaxed);
+    return pass;
+}
+
+bool LogGate::limit()
+{
+    const qint64 now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    const qint64 interval = m_interval.load(std::memory_order_relaxed);
+    const qint64 tolerance = m_tolerance.load(std::memory_order_relaxed);
+
+    qint64 next = m_nextFree.load(std::memory_order_relaxed);
+    while (true) {
+        const qint64 start = qMax(next, now);
+        if (start - now > tolerance) return false;
+        if (m_nextFree.compare_exchange_weak(next, start + interval, std::memory_order_relaxed)) return true;
+    }
+}
+
+quint64 LogGate::admitted() const
+{
+    return m_admitted.load(std::memory_order_relaxed);
+}
+
+quint64 LogGate::suppressed() const
+{
+    return m_suppressed.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,38 @@
+#ifndef LOGGATE_H
+#define LOGGATE_H
+
+#include <QtGlobal>
+#include <atomic>
+
+// Admission control for one logging category: keeps 1 message in every N, then
+// rate limits what is left with a token bucket. The bucket is a single atomic
+// "next allowed time", so admit() never takes a lock.
+class LogGate
+{
+public:
+    LogGate() = default;
+    LogGate(const LogGate &) = delete;
+    LogGate &operator=(const LogGate &) = delete;
+
+    // perSecond 0 removes the limit; burst is how many may go through back to back
+    void setRate(double perSecond, int burst = 1);
+    void setSampling(int everyNth);
+
+    bool admit();
+
+    quint64 admitted() const;
+    quint64 suppressed() const;
+
+private:
+    bool limit();
+
+    std::atomic<qint64> m_interval{0};  // Nanoseconds per token, 0 when unlimited
+    std::atomic<qint64> m_tolerance{0}; // How far ahead of now the bucket may run
+    std::atomic<qint64> m_nextFree{0};
+    std::atomic<quint32> m_sampling{1};
+    std::atomic<quint32> m_seen{0};
+    std::atomic<quint64> m_admitted{0};
+    std::atomic<quint64> m_suppressed{0};
+};
+
+#endif // LOGGATE_H
@@ -0,0 +1,186 @@
+#include "loopwatchdog.h"
+#include <QAbstractEventDispatcher>
+#include <QThread>
+
+#if defined(Q_OS_LINUX) || defined(Q_OS_MACOS)
+#define LOOPWATCHDOG_STACKS 1
+#include <csignal>
+#include <cstdlib>
+#include <execinfo.h>
+#include <pthread.h>
+#endif
+
+namespace {
+
+#ifdef LOOPWATCHDOG_STACKS
+constexpr int MaxFrames = 64;
+void *frames[MaxFrames];
+std::atomic<int> frameCount{-1};
+
+void captureStack(int)
+{
+    frameCount.store(backtrace(frames, MaxFrames), std::memory_order_release);
+}
+#endif
+
+} // namespace
+
+LoopWatchdog::LoopWatchdog(QObject *parent)
+    : QObject{parent}
+{
+    m_clock.start();
+#ifdef LOOPWATCHDOG_STACKS
+    m_nativeThread = quintptr(pthread_self());
+#endif
+}
+
+LoopWatchdog::~LoopWatchdog()
+{
+    stop();
+}
+
+void LoopWatchdog::setStallThreshold(int msecs)
+{
+    m_threshold = qMax(1, msecs);
+}
+
+int LoopWatchdog::stallThreshold() const
+{
+    return m_threshold;
+}
+
+void LoopWatchdog::start()
+{
+    if (m_running) return;
+
+    QAbstractEventDispatcher *dispatcher = QAbstractEventDispatcher::instance(thread());
+    if (!dispatcher) {
+        qWarning() << "LoopWatchdog: no event dispatcher in" << thread();
+        return;
+    }
+    connect(dispatcher, &QAbstractEventDispatcher::awake, this, &LoopWatchdog::awake, Qt::DirectConnection);
+    connect(dispatcher, &QAbstractEventDispatcher::aboutToBlock, this, &LoopWatchdog::aboutToBlock, Qt::DirectConnection);
+
+#ifdef LOOPWATCHDOG_STACKS
+    // backtrace() may allocate the first time it runs; never let that happen in the handler
+    backtrace(frames, MaxFrames);
+    struct sigaction action = {};
+    action.sa_handler = captureStack;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    sigaction(SIGUSR2, &action, nullptr);
+#endif
+
+    m_running = true;
+    m_busySince = m_clock.nsecsElapsed();
+    m_monitor = QThread::create([this] { monitor(); });
+    m_monitor->start();
+}
+
+void LoopWatchdog::stop()
+{
+    if (!m_running) return;
+    m_running = false;
+    m_monitor->wait();
+    delete m_monitor;
+    m_monitor = nullptr;
+
+    if (QAbstractEventDispatcher *dispatcher = QAbstractEventDispatcher::instance(thread())) {
+        disconnect(dispatcher, nullptr, this, nullptr);
+    }
+}
+
+void LoopWatchdog::trackTimer(QTimer *timer)
+{
+    m_lastTimeout.insert(timer, -1);
+    connect(timer, &QTimer::timeout, this, [this, timer] {
+        const qint64 now = m_clock.nsecsElapsed();
+        qint64 &last = m_lastTimeout[timer];
+        if (last >= 0) m_lateness.record(qAbs(now - last - qint64(timer->interval()) * 1000000));
+        last = now;
+    });
+    connect(timer, &QObject::destroyed, this, [this, timer] { m_lastTimeout.remove(timer); });
+}
+
+const LatencyHistogram &LoopWatchdog::iterations() const
+{
+    return m_iterations;
+}
+
+const LatencyHistogram &LoopWatchdog::timerLateness() const
+{
+    return m_lateness;
+}
+
+int LoopWatchdog::stalls() const
+{
+    return m_stalls;
+}
+
+QStringList LoopWatchdog::stallStacks() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_stacks;
+}
+
+void LoopWatchdog::awake()
+{
+    m_busySince.store(m_clock.nsecsElapsed(), std::memory_order_relaxed);
+}
+
+void LoopWatchdog::aboutToBlock()
+{
+    const qint64 since = m_busySince.exchange(-1, std::memory_order_relaxed);
+    if (since >= 0) m_iterations.record(m_clock.nsecsElapsed() - since);
+}
+
+void LoopWatchdog::monitor()
+{
+    qint64 reported = -1;
+    while (m_running) {
+        QThread::msleep(ulong(qMax(1, m_threshold.load() / 4)));
+
+        const qint64 since = m_busySince.load(std::memory_order_relaxed);
+        if (since < 0 || since == reported) continue;
+
+        const qint64 busy = (m_clock.nsecsElapsed() - since) / 1000000;
+        if (busy < m_threshold) continue;
+
+        // One sample per stalled iteration
+        reported = since;
+        m_stalls++;
+        QString stack = sampleStack();
+        {
+            QMutexLocker locker(&m_mutex);
+            m_stacks.append(QString("Stalled %1 ms\n%2").arg(busy).arg(stack));
+        }
+        emit stalled(busy);
+    }
+}
+
+QString LoopWatchdog::sampleStack()
+{
+#ifdef LOOPWATCHDOG_STACKS
+    frameCount.store(-1, std::memory_order_relaxed);
+    if (pthread_kill(pthread_t(m_nativeThread), SIGUSR2) != 0) return QString();
+
+    for (int waited = 0; frameCount.load(std::memory_order_acquire) < 0 && waited < 100; waited++) QThread::msleep(1);
+    const int count = frameCount.load(std::memory_order_acquire);
+    if (count <= 0) return QString("  (no sample)");
+
+    QStringList lines;
+    char **symbols = backtrace_symbols(frames, count);
+    for (int i = 0; i < count; i++) lines << QString("  %1").arg(symbols ? symbols[i] : "?");
+    free(symbols);
+    return lines.join('\n');
+#else
+    return QString("  (stack samples not supported here)");
+#endif
+}
+
+void LoopWatchdog::dump() const
+{
+    for (const QString &line : m_iterations.dump("Event loop iterations")) qInfo().noquote() << line;
+    for (const QString &line : m_lateness.dump("Timer lateness")) qInfo().noquote() << line;
+    for (const QString &stack : stallStacks()) qInfo().noquote() << stack;
+}
@@ -0,0 +1,67 @@
+#ifndef LOOPWATCHDOG_H
+#define LOOPWATCHDOG_H
+
+#include <QObject>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QStringList>
+#include <QThread>
+#include <QTimer>
+#include <atomic>
+#include "latencyhistogram.h"
+
+// Watches the event loop of the thread it is created in. Every iteration's busy
+// time (awake to aboutToBlock) and the lateness of tracked timers go into
+// histograms. A monitor thread notices iterations running past the stall
+// threshold and grabs a stack sample of the watched thread where it can.
+class LoopWatchdog : public QObject
+{
+    Q_OBJECT
+public:
+    explicit LoopWatchdog(QObject *parent = nullptr);
+    ~LoopWatchdog();
+
+    void setStallThreshold(int msecs);
+    int stallThreshold() const;
+
+    void start();
+    void stop();
+
+    void trackTimer(QTimer *timer);
+
+    const LatencyHistogram &iterations() const;
+    const LatencyHistogram &timerLateness() const;
+    int stalls() const;
+    QStringList stallStacks() const;
+
+signals:
+    void stalled(qint64 msecs);
+
+public slots:
+    void dump() const;
+
+private:
+    void awake();
+    void aboutToBlock();
+    void monitor();
+    QString sampleStack();
+
+    QElapsedTimer m_clock;
+    std::atomic<qint64> m_busySince{-1};
+    std::atomic<int> m_threshold{100};
+    std::atomic<bool> m_running{false};
+    QThread *m_monitor = nullptr;
+    quintptr m_nativeThread = 0;
+
+    LatencyHistogram m_iterations;
+    LatencyHistogram m_lateness;
+    QHash<QTimer *, qint64> m_lastTimeout;
+
+    mutable QMutex m_mutex;
+    QStringList m_stacks;
+    std::atomic<int> m_stalls{0};
+};
+
+#endif // LOOPWATCHDOG_H
@@ -3,14 +3,40 @@
 #include <QObject>
 #include <QVariant>
 #include <QTextStream>
+#include <QThread>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QTimer>
+#include <QFile>
+#include <QDir>
+#include <QSettings>
 #include <array>
 #include <iostream>
+#include <atomic>
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <memory>
+#include <vector>
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 #include "animal.h"
 #include "laptop.h"
 #include "feline.h"
 #include "canine.h"
 #include "appliance.h"
 #include "agecalc.h"
+#include "speciesregistry.h"
+#include "ageindex.h"
+#include "csvimporter.h"
+#include "agereport.h"
+#include "laptopfleet.h"
+#include "fleetstats.h"
+#include "applianceinterfaces.h"
+#include "appliancequeue.h"
 #include "teststaticfunctions.h"
 #include "source.h"
 #include "destination.h"
@@ -18,10 +44,28 @@
 #include "station.h"
 #include "testqproperty.h"
 #include "watcher.h"
+#include "boundedqueue.h"
+#include "journal.h"
+#include "journalreplay.h"
+#include "consumergroup.h"
+#include "shmlink.h"
+#include "consolesink.h"
+#include "logcategories.h"
+#include "loopwatchdog.h"
+#include "virtualscheduler.h"
+#include "teardown.h"
+#include "zoo.h"
+#include "snapshot.h"
+#include "snapshotwriter.h"
+#ifdef Q_OS_LINUX
+#include "epolldispatcher.h"
+#endif
 
 using namespace std;
 
 int Animal::count = 0;
+std::atomic<bool> Animal::quiet{false};
+std::atomic<bool> Laptop::quiet{false};
 
 void test() {
     qInfo("Hello from test");
@@ -40,11 +84,13 @@ int calc(int offset, int age) {
 }
 
 int catYears(int age) {
-    return calc(9, age);
+    if (!SpeciesRegistry::isValidAge(age)) qFatal("Invalid age");
+    return SpeciesRegistry::years<Feline>(age);
 }
 
 int dogYears(int age) {
-    return calc(7, age);
+    if (!SpeciesRegistry::isValidAge(age)) qFatal("Invalid age");
+    return SpeciesRegistry::years<Canine>(age);
 }
 
 void testVal(int x) {
@@ -86,10 +132,967 @@ void printAges(AgeCalc &calc) {
     qInfo() << calc.name() << "Cat Years: " << calc.catYears();
 }
 
+qint64 residentKb() {
+#ifdef Q_OS_LINUX
+    QFile statm("/proc/self/statm");
+    if (statm.open(QIODevice::ReadOnly)) {
+        QList<QByteArray> fields = statm.readAll().split(' ');
+        if (fields.size() > 1) return fields.at(1).toLongLong() * (sysconf(_SC_PAGESIZE) / 1024);
+    }
+#endif
+#ifdef Q_OS_UNIX
+    // Peak rather than current, but still flat when nothing is leaking
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef Q_OS_MACOS
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+#else
+    return 0;
+#endif
+}
+
+void silentHandler(QtMsgType, const QMessageLogContext &, const QString &) {}
+
+std::atomic<qint64> handledMessages{0};
+
+void countingHandler(QtMsgType, const QMessageLogContext &, const QString &) {
+    handledMessages.fetch_add(1, std::memory_order_relaxed);
+}
+
+void soakBoundedQueue(BoundedQueue::Policy policy, int seconds) {
+    Radio boombox;
+    Station *station = new Station(&boombox, 94, "Rock and Roll");
+    BoundedQueue *queue = new BoundedQueue(&boombox, 1024, policy);
+    queue->attach(station);
+
+    QtMessageHandler previous = qInstallMessageHandler(silentHandler);
+
+    // Measure what the radio can consume, then produce ten times that
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < 10000; i++) boombox.listen(94, "Rock and Roll", "Calibrating");
+    qint64 consumeRate = 10000LL * 1000000000LL / qMax<qint64>(1, timer.nsecsElapsed());
+    qint64 produceRate = qMax<qint64>(1, consumeRate) * 10;
+
+    std::atomic<bool> running{true};
+    QThread *producer = QThread::create([&] {
+        QElapsedTimer clock;
+        clock.start();
+        qint64 sent = 0;
+        while (running) {
+            qint64 due = produceRate * clock.nsecsElapsed() / 1000000000LL;
+            while (sent < due && running) {
+                station->broadcast("Overload");
+                sent++;
+            }
+            QThread::usleep(100);
+        }
+    });
+
+    QVector<qint64> samples;
+    QEventLoop loop;
+    QTimer sampler;
+    QObject::connect(&sampler, &QTimer::timeout, &loop, [&] {
+        samples.append(residentKb());
+        if (samples.size() >= seconds) running = false;
+    });
+    QObject::connect(producer, &QThread::finished, &loop, &QEventLoop::quit);
+
+    sampler.start(1000);
+    producer->start();
+    loop.exec();
+    producer->wait();
+    delete producer;
+
+    qInstallMessageHandler(previous);
+
+    qInfo() << "Policy:" << policy << "Consume/s:" << consumeRate << "Produce/s:" << produceRate;
+    qInfo() << "Delivered:" << queue->delivered() << "Dropped:" << queue->dropped()
+            << "Blocked:" << queue->blocked() << "Coalesced:" << queue->coalesced();
+    qInfo() << "RSS KB per second:" << samples;
+}
+
+void benchmarkJournal(int count) {
+    QDir dir(QDir::tempPath() + "/one-journal");
+    dir.removeRecursively();
+
+    Journal journal(dir.path());
+    journal.setFlushInterval(2);
+    if (!journal.open()) return;
+
+    QString name = "Rock and Roll";
+    QString message = "Broadcasting live";
+
+    QElapsedTimer timer;
+    timer.start();
+    quint64 last = 0;
+    for (int i = 0; i < count; i++) last = journal.append(94, name, message);
+    qint64 appended = timer.nsecsElapsed();
+    journal.waitForDurable(last);
+    qint64 durable = timer.nsecsElapsed();
+
+    qInfo() << "Appended" << count << "in" << appended / 1000000 << "ms:"
+            << qint64(count) * 1000000000LL / qMax<qint64>(1, appended) << "msgs/s";
+    qInfo() << "Durable after" << durable / 1000000 << "ms, segments:" << journal.segmentFiles().size();
+}
+
+void recoverJournal() {
+    QDir dir(QDir::tempPath() + "/one-journal-crash");
+    dir.removeRecursively();
+
+    const int written = 1000;
+    QString name = "News";
+    QString message = "Broadcasting live";
+    {
+        Journal journal(dir.path());
+        if (!journal.open()) return;
+        for (int i = 0; i < written; i++) journal.append(104, name, message);
+    }
+
+    // Simulate a crash part way through the last record
+    QString last = Journal(dir.path()).segmentFiles().constLast();
+    qint64 record = JournalFormat::recordSize(quint32((name.size() + message.size()) * 2));
+    qint64 tail = sizeof(JournalFormat::SegmentHeader) + written * record;
+    QFile(last).resize(tail - record / 2);
+
+    Journal journal(dir.path());
+    if (!journal.open()) return;
+    qInfo() << "Recovered" << journal.recovered() << "of" << written << "next sequence" << journal.lastSequence() + 1;
+
+    Radio boombox;
+    QtMessageHandler previous = qInstallMessageHandler(silentHandler);
+    quint64 replayed = journal.replay(&boombox);
+    qInstallMessageHandler(previous);
+    qInfo() << "Replayed" << replayed << "into the radio";
+}
+
+void replayJournal(JournalReplay::Pace pace, double speed) {
+    JournalReplay replay(QDir::tempPath() + "/one-journal");
+    replay.setPace(pace);
+    replay.setSpeed(speed);
+    if (!replay.open()) return;
+
+    Radio boombox;
+    QtMessageHandler previous = qInstallMessageHandler(silentHandler);
+    QElapsedTimer timer;
+    timer.start();
+    quint64 delivered = replay.replay(&boombox);
+    qint64 elapsed = timer.nsecsElapsed();
+    qInstallMessageHandler(previous);
+
+    qInfo() << pace << "x" << speed << "replayed" << delivered << "from" << replay.bytes() / 1024 << "KB in"
+            << elapsed / 1000000 << "ms:" << qint64(delivered) * 1000000000LL / qMax<qint64>(1, elapsed) << "msgs/s";
+}
+
+void consumerGroups(int consumers) {
+    ConsumerGroup group("speakers", 8);
+    QSettings offsets(QDir::tempPath() + "/one-offsets.ini", QSettings::IniFormat);
+    group.loadOffsets(offsets);
+
+    QObject::connect(&group, &ConsumerGroup::rebalanced, [&group] {
+        for (Radio *member : group.members()) qInfo() << member << "owns" << group.assignment(member);
+    });
+
+    // One radio per thread, each listening to its share of the channels
+    QList<QThread *> threads;
+    QList<Radio *> members;
+    for (int i = 0; i < consumers; i++) {
+        QThread *thread = new QThread;
+        Radio *radio = new Radio;
+        radio->moveToThread(thread);
+        thread->start();
+        threads.append(thread);
+        members.append(radio);
+        group.join(radio);
+    }
+
+    Radio boombox;
+    Station* channels[3];
+    channels[0] = new Station(&boombox, 94, "Rock and Roll");
+    channels[1] = new Station(&boombox, 87, "Hip Hop");
+    channels[2] = new Station(&boombox, 104, "News");
+    for (Station *channel : channels) {
+        QObject::connect(channel, &Station::send, &group, &ConsumerGroup::publish);
+        channel->broadcast("Broadcasting live");
+    }
+
+    // A consumer leaving hands its partitions to the others
+    group.leave(members.last());
+    for (Station *channel : channels) channel->broadcast("After rebalance");
+
+    while (group.lag() > 0) QThread::msleep(1);
+    group.saveOffsets(offsets);
+    qInfo() << "Group" << group.name() << "lag" << group.lag() << "offsets saved to" << offsets.fileName();
+
+    for (QThread *thread : threads) {
+        thread->quit();
+        thread->wait();
+        delete thread;
+    }
+    qDeleteAll(members);
+}
+
+void shmBenchmark(int count, int busyPoll) {
+#ifdef Q_OS_UNIX
+    ShmRing ring;
+    if (!ring.createAnonymous(1 << 22)) {
+        qWarning() << "Could not create the shared ring";
+        return;
+    }
+    ring.setBusyPoll(busyPoll);
+
+    pid_t child = fork();
+    if (child == 0) {
+        // Process B: drain the ring and measure one-way latency from the send timestamps
+        QVector<qint64> latencies;
+        latencies.reserve(count);
+        QElapsedTimer timer;
+        while (latencies.size() < count) {
+            if (!ring.waitForData(1000)) break;
+            if (!timer.isValid()) timer.start();
+            ring.read([&latencies](const ShmRing::Message &message) {
+                qint64 now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count();
+                latencies.append(now - message.timestamp);
+            });
+        }
+        qint64 elapsed = timer.nsecsElapsed();
+
+        std::sort(latencies.begin(), latencies.end());
+        if (!latencies.isEmpty()) {
+            qInfo() << "Busy poll" << busyPoll << "received" << latencies.size() << "in" << elapsed / 1000000 << "ms:"
+                    << qint64(latencies.size()) * 1000000000LL / qMax<qint64>(1, elapsed) << "msgs/s";
+            qInfo() << "Latency ns p50" << latencies.at(latencies.size() / 2)
+                    << "p99" << latencies.at(latencies.size() * 99 / 100) << "max" << latencies.constLast();
+        }
+        _exit(0);
+    }
+
+    // Process A: a station sending through the ring
+    Radio boombox;
+    Station *station = new Station(&boombox, 94, "Rock and Roll");
+    ShmSender sender(&ring);
+    QObject::connect(station, &Station::send, &sender, &ShmSender::send);
+    for (int i = 0; i < count; i++) station->broadcast("Broadcasting live");
+
+    int status = 0;
+    waitpid(child, &status, 0);
+    qInfo() << "Sent" << sender.sent() << "dropped" << sender.dropped();
+#else
+    Q_UNUSED(count);
+    Q_UNUSED(busyPoll);
+#endif
+}
+
+void benchmarkRadioOff(int count) {
+    Radio boombox;
+    Station *station = new Station(&boombox, 94, "Rock and Roll");
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < count; i++) station->broadcast(QString("Track %1").arg(i));
+    qint64 eager = timer.nsecsElapsed();
+
+    timer.restart();
+    for (int i = 0; i < count; i++) station->broadcastWith([i] { return QString("Track %1").arg(i); });
+    qint64 lazy = timer.nsecsElapsed();
+
+    timer.restart();
+    for (int i = 0; i < count; i++) station->broadcastFormat("Track %1", i);
+    qint64 format = timer.nsecsElapsed();
+
+    qInfo() << "Radio off, ns per call - eager:" << double(eager) / count
+            << "lazy:" << double(lazy) / count << "format:" << double(format) / count;
+}
+
+void benchmarkInterest(int stations, int rounds) {
+    Radio boombox;
+    QList<Station *> channels;
+    for (int i = 0; i < stations; i++) {
+        Station *station = new Station(&boombox, i, QString("Station %1").arg(i));
+        boombox.tune(station);
+        channels.append(station);
+    }
+
+    QtMessageHandler previous = qInstallMessageHandler(silentHandler);
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int round = 0; round < rounds; round++) {
+        for (Station *station : channels) station->broadcastFormat("Round %1", round);
+    }
+    qint64 everything = timer.nsecsElapsed();
+
+    // 1% interest: every hundredth channel
+    QList<int> wanted;
+    for (int i = 0; i < stations; i += 100) wanted.append(i);
+    boombox.setInterest(wanted);
+
+    timer.restart();
+    for (int round = 0; round < rounds; round++) {
+        for (Station *station : channels) station->broadcastFormat("Round %1", round);
+    }
+    qint64 filtered = timer.nsecsElapsed();
+
+    qInstallMessageHandler(previous);
+
+    qint64 calls = qint64(stations) * rounds;
+    qInfo() << stations << "stations, ns per broadcast - all channels:" << double(everything) / calls
+            << "1% interest:" << double(filtered) / calls;
+}
+
+void benchmarkDirectory(int stations, int lookups) {
+    Radio boombox;
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < stations; i++) new Station(&boombox, i, QString("Station %1").arg(i));
+    qint64 build = timer.nsecsElapsed();
+
+    QStringList names;
+    for (int i = 0; i < lookups; i++) names.append(QString("Station %1").arg((i * 7919) % stations));
+
+    timer.restart();
+    qint64 found = 0;
+    for (int i = 0; i < lookups; i++) found += boombox.station((i * 7919) % stations) != nullptr;
+    qint64 byChannel = timer.nsecsElapsed();
+
+    timer.restart();
+    for (const QString &name : names) found += boombox.station(name) != nullptr;
+    qint64 byName = timer.nsecsElapsed();
+
+    // The old way, for a handful of lookups only
+    const int scans = qMin(lookups, 100);
+    timer.restart();
+    for (int i = 0; i < scans; i++) {
+        int channel = (i * 7919) % stations;
+        for (Station *station : boombox.findChildren<Station *>()) {
+            if (station->channel == channel) {
+                found++;
+                break;
+            }
+        }
+    }
+    qint64 scanned = timer.nsecsElapsed();
+
+    timer.restart();
+    for (int i = 0; i < stations; i += 2) delete boombox.station(i);
+    qint64 removed = timer.nsecsElapsed();
+
+    qInfo() << stations << "stations, build ms:" << build / 1000000 << "found:" << found;
+    qInfo() << "ns per lookup - channel:" << double(byChannel) / lookups << "name:" << double(byName) / lookups
+            << "findChildren:" << double(scanned) / scans;
+    qInfo() << "Deleted half in ms:" << removed / 1000000 << "remaining:" << boombox.stationCount();
+}
+
+void benchmarkTeardown(int children) {
+    QElapsedTimer timer;
+
+    // The baseline: ~QObject deleting its own children
+    QObject *owner = new QObject;
+    for (int i = 0; i < children; i++) new Station(owner, i, "Static");
+    timer.start();
+    delete owner;
+    const qint64 destructor = timer.nsecsElapsed();
+
+    Radio boombox;
+    for (int i = 0; i < children; i++) new Station(&boombox, i, "Static");
+    timer.restart();
+    boombox.teardown();
+    const qint64 radio = timer.nsecsElapsed();
+
+    QObject family;
+    for (int i = 0; i < children; i++) new Station(&family, i, "Static");
+    timer.restart();
+    Teardown::children(&family, Teardown::Silent);
+    const qint64 silent = timer.nsecsElapsed();
+
+    const bool wasQuiet = Animal::quiet;
+    Animal::quiet = true;
+    QObject zoo;
+    for (int i = 0; i < children; i++) {
+        if (i % 2) new Canine(&zoo); else new Feline(&zoo);
+    }
+    Animal::quiet = wasQuiet;
+    timer.restart();
+    Animal::teardown(&zoo);
+    const qint64 animals = timer.nsecsElapsed();
+
+    qInfo() << children << "children, teardown ms - ~QObject:" << destructor / 1000000
+            << "radio:" << radio / 1000000 << "silent:" << silent / 1000000 << "animals:" << animals / 1000000;
+}
+
+qint64 deliverFromThread(Station *station, int count) {
+    handledMessages = 0;
+    QtMessageHandler previous = qInstallMessageHandler(countingHandler);
+
+    QElapsedTimer timer;
+    timer.start();
+    QThread *producer = QThread::create([station, count] {
+        for (int i = 0; i < count; i++) station->broadcast("Broadcasting live");
+    });
+    producer->start();
+    while (handledMessages < count) QCoreApplication::processEvents(QEventLoop::AllEvents);
+    qint64 elapsed = timer.nsecsElapsed();
+
+    producer->wait();
+    delete producer;
+    qInstallMessageHandler(previous);
+    return elapsed;
+}
+
+void benchmarkBatching(int count) {
+    Radio boombox;
+    Station *station = new Station(&boombox, 94, "Rock and Roll");
+
+    // One posted event and one listen() per message
+    QObject::connect(station, &Station::send, &boombox, &Radio::listen, Qt::QueuedConnection);
+    qint64 single = deliverFromThread(station, count);
+    QObject::disconnect(station, &Station::send, &boombox, &Radio::listen);
+
+    BoundedQueue *queue = new BoundedQueue(&boombox, 65536, BoundedQueue::Block);
+    queue->setBatching(1024, 1);
+    queue->attach(station);
+    qint64 batched = deliverFromThread(station, count);
+
+    qInfo() << count << "messages, ms - per message:" << single / 1000000 << "batched:" << batched / 1000000
+            << "in" << queue->batches() << "batches";
+}
+
+void benchmarkConsole(int count) {
+    Radio boombox;
+    Station *station = new Station(&boombox, 94, "Rock and Roll");
+    boombox.tune(station);
+
+    ConsoleSink::install();
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < count; i++) station->broadcastFormat("Track %1", i);
+    ConsoleSink::flush();
+    qint64 elapsed = timer.nsecsElapsed();
+    ConsoleSink::uninstall();
+
+    qInfo() << count << "lines in" << elapsed / 1000000 << "ms:"
+            << qint64(count) * 1000000000LL / qMax<qint64>(1, elapsed) << "lines/s";
+}
+
+void benchmarkLogGates(int count) {
+    Radio boombox;
+    Station *station = new Station(&boombox, 94, "Rock and Roll");
+    boombox.tune(station);
+
+    handledMessages = 0;
+    QtMessageHandler previous = qInstallMessageHandler(countingHandler);
+    QElapsedTimer timer;
+
+    lcRadioGate.setSampling(100);
+    timer.start();
+    for (int i = 0; i < count; i++) station->broadcast("Sampled");
+    qint64 sampled = timer.nsecsElapsed();
+    lcRadioGate.setSampling(1);
+
+    lcRadioGate.setRate(1000, 100);
+    timer.restart();
+    for (int i = 0; i < count; i++) station->broadcast("Limited");
+    qint64 limited = timer.nsecsElapsed();
+    lcRadioGate.setRate(0);
+
+    QLoggingCategory::setFilterRules("one.radio.info=false");
+    timer.restart();
+    for (int i = 0; i < count; i++) station->broadcast("Disabled");
+    qint64 disabled = timer.nsecsElapsed();
+    QLoggingCategory::setFilterRules(QString());
+
+    qInstallMessageHandler(previous);
+    qInfo() << "ns per listen - 1 in 100:" << double(sampled) / count << "1000/s:" << double(limited) / count
+            << "disabled:" << double(disabled) / count;
+    qInfo() << "Printed" << handledMessages.load() << "admitted" << lcRadioGate.admitted()
+            << "suppressed" << lcRadioGate.suppressed();
+}
+
+
+void simulateTickers(int objects, qint64 simulatedMsecs) {
+    QtMessageHandler previous = qInstallMessageHandler(silentHandler);
+    VirtualScheduler scheduler;
+
+    QElapsedTimer timer;
+    timer.start();
+    std::unique_ptr<QObject> parent(new QObject);
+    for (int i = 0; i < objects; i++) new TestQProperty(&scheduler, parent.get());
+    const qint64 setupMs = timer.restart();
+
+    scheduler.advance(simulatedMsecs);
+    const qint64 runNs = timer.nsecsElapsed();
+
+    Teardown::children(parent.get());
+    qInstallMessageHandler(previous);
+
+    qInfo() << objects << "tickers," << simulatedMsecs / 1000 << "simulated seconds in" << runNs / 1000000 << "ms:"
+            << scheduler.fired() << "timeouts," << (scheduler.fired() ? runNs / qint64(scheduler.fired()) : 0) << "ns each,"
+            << "setup" << setupMs << "ms";
+}
+
+void benchmarkZoo(int animals) {
+    const bool wasQuiet = Animal::quiet;
+    Animal::quiet = true;
+    QElapsedTimer timer;
+
+    // Interleaved, the way a mixed QList<Animal*> usually ends up
+    std::vector<Animal *> pointers;
+    pointers.reserve(size_t(animals));
+    for (int i = 0; i < animals; i++) pointers.push_back(i % 2 ? static_cast<Animal *>(new Feline) : new Canine);
+
+    quint64 dogs = 0;
+    quint64 cats = 0;
+    timer.start();
+    for (Animal *animal : pointers) {
+        if (Canine *canine = qobject_cast<Canine *>(animal)) dogs += canine->name.isEmpty();
+        else if (Feline *feline = qobject_cast<Feline *>(animal)) cats += feline->name.isEmpty();
+    }
+    const qint64 castNs = timer.nsecsElapsed();
+    qDeleteAll(pointers);
+    pointers.clear();
+
+    Zoo zoo;
+    for (int i = 0; i < animals; i++) {
+        if (i % 2) zoo.add<Feline>();
+        else zoo.add<Canine>();
+    }
+
+    quint64 zooDogs = 0;
+    quint64 zooCats = 0;
+    timer.restart();
+    zoo.visit(Overloaded{
+        [&](Canine &canine) { zooDogs += canine.name.isEmpty(); },
+        [&](Feline &feline) { zooCats += feline.name.isEmpty(); },
+    });
+    const qint64 visitNs = timer.nsecsElapsed();
+    zoo.clear();
+    Animal::quiet = wasQuiet;
+
+    qInfo() << animals << "animals, ns per animal - qobject_cast:" << double(castNs) / animals
+            << "zoo:" << double(visitNs) / animals
+            << "(" << dogs << cats << "/" << zooDogs << zooCats << ")";
+}
+
+void benchmarkTypeChecks(int animals) {
+    const bool wasQuiet = Animal::quiet;
+    Animal::quiet = true;
+
+    std::vector<Animal *> pointers;
+    pointers.reserve(size_t(animals));
+    for (int i = 0; i < animals; i++) {
+        switch (i % 3) {
+        case 0: pointers.push_back(new Canine); break;
+        case 1: pointers.push_back(new Feline); break;
+        default: pointers.push_back(new Animal); break;
+        }
+    }
+
+    QElapsedTimer timer;
+    quint64 castHits = 0;
+    timer.start();
+    for (Animal *animal : pointers) castHits += (qobject_cast<Mammal *>(animal) != nullptr) + (qobject_cast<Canine *>(animal) != nullptr);
+    const qint64 castNs = timer.nsecsElapsed();
+
+    quint64 inheritsHits = 0;
+    timer.restart();
+    for (Animal *animal : pointers) inheritsHits += animal->inherits("Mammal") + animal->inherits("Canine");
+    const qint64 inheritsNs = timer.nsecsElapsed();
+
+    quint64 tagHits = 0;
+    timer.restart();
+    for (Animal *animal : pointers) tagHits += animal->is<Mammal>() + animal->is<Canine>();
+    const qint64 tagNs = timer.nsecsElapsed();
+
+    qDeleteAll(pointers);
+    Animal::quiet = wasQuiet;
+
+    qInfo() << animals << "animals, ns per two checks - qobject_cast:" << double(castNs) / animals
+            << "inherits:" << double(inheritsNs) / animals << "type tag:" << double(tagNs) / animals
+            << "(" << castHits << inheritsHits << tagHits << ")";
+}
+
+void benchmarkSnapshot(int perType) {
+    const QString path = QDir::tempPath() + "/one-population.snap";
+    QtMessageHandler previous = qInstallMessageHandler(silentHandler);
+    QElapsedTimer timer;
+
+    // The slow way: every object through its logging constructor, names built one by one
+    timer.start();
+    QObject population;
+    for (int i = 0; i < perType; i++) {
+        const QString name = QString("Name %1").arg(i % 1000);
+        Animal *animal = i % 2 ? static_cast<Animal *>(new Canine(&population)) : new Feline(&population);
+        animal->name = name;
+        Laptop *laptop = new Laptop(&population, name);
+        laptop->weight = 3 + i % 5;
+        AgeCalc *calc = new AgeCalc(&population);
+        calc->setName(name);
+        calc->setAge(1 + i % 120);
+        new Station(&population, i % 1024, name);
+    }
+    const qint64 buildMs = timer.restart();
+
+    SnapshotWriter writer;
+    writer.addChildren(&population);
+    writer.save(path);
+    const qint64 saveMs = timer.restart();
+    Animal::teardown(&population);
+
+    Snapshot snapshot(path);
+    timer.restart();
+    snapshot.open();
+    qint64 weights = 0;
+    for (int i = 0; i < snapshot.laptopCount(); i++) weights += snapshot.laptop(i).weight;
+    const qint64 viewMs = timer.restart();
+
+    QObject reloaded;
+    const int objects = snapshot.materialize(&reloaded);
+    const qint64 materializeMs = timer.elapsed();
+    Animal::teardown(&reloaded);
+    qInstallMessageHandler(previous);
+
+    qInfo() << objects << "objects, ms - constructors:" << buildMs << "save:" << saveMs
+            << "open and view:" << viewMs << "materialize:" << materializeMs << "(" << weights << ")";
+    QFile::remove(path);
+}
+
+void benchmarkSpecies(int conversions) {
+    QtMessageHandler previous = qInstallMessageHandler(silentHandler);
+    QElapsedTimer timer;
+
+    qint64 chain = 0;
+    timer.start();
+    for (int i = 0; i < conversions; i++) chain += calc(7, 1 + i % 120);
+    const qint64 chainNs = timer.nsecsElapsed();
+    qInstallMessageHandler(previous);
+
+    qint64 builtin = 0;
+    timer.restart();
+    for (int i = 0; i < conversions; i++) builtin += SpeciesRegistry::years<Canine>(1 + i % 120);
+    const qint64 builtinNs = timer.nsecsElapsed();
+
+    const int tortoise = SpeciesRegistry::registerSpecies("Tortoise", 1);
+    const int species[] = {Animal::CanineType, Animal::FelineType, tortoise};
+    qint64 runtime = 0;
+    timer.restart();
+    for (int i = 0; i < conversions; i++) runtime += SpeciesRegistry::years(species[i % 3], 1 + i % 120);
+    const qint64 runtimeNs = timer.nsecsElapsed();
+
+    qInfo() << conversions << "conversions, ns each - calc():" << double(chainNs) / conversions
+            << "years<Canine>:" << double(builtinNs) / conversions
+            << "years(species):" << double(runtimeNs) / conversions
+            << "(" << chain << builtin << runtime << ")";
+}
+
+void benchmarkAgeIndex(int records) {
+    QObject population;
+    AgeIndex index;
+    for (int i = 0; i < records; i++) {
+        AgeCalc *calc = new AgeCalc(&population);
+        calc->setName(i == records / 2 ? QString("Bryan") : QString("Name %1").arg(i % 100000));
+        calc->setAge(1 + (i * 37) % 120);
+        index.add(calc);
+    }
+    const QList<AgeCalc *> calcs = population.findChildren<AgeCalc *>(QString(), Qt::FindDirectChildrenOnly);
+    QElapsedTimer timer;
+
+    int scanned = 0;
+    timer.start();
+    for (AgeCalc *calc : calcs) scanned += calc->dogYears() >= 100 && calc->dogYears() <= 200;
+    AgeCalc *scannedBryan = nullptr;
+    for (AgeCalc *calc : calcs) {
+        if (calc->name() == QLatin1String("Bryan")) {
+            scannedBryan = calc;
+            break;
+        }
+    }
+    const qint64 scanNs = timer.nsecsElapsed();
+
+    int indexed = 0;
+    timer.restart();
+    index.forEachInYears<Canine>(100, 200, [&indexed](AgeCalc *) { indexed++; });
+    AgeCalc *indexedBryan = index.find("Bryan");
+    const qint64 indexNs = timer.nsecsElapsed();
+
+    // Everyone has a birthday
+    timer.restart();
+    for (AgeCalc *calc : calcs) calc->setAge(calc->age() % 120 + 1);
+    const qint64 updateNs = timer.nsecsElapsed();
+
+    qInfo() << records << "records - scan:" << scanNs / 1000 << "us, index:" << indexNs / 1000 << "us,"
+            << "update" << updateNs / records << "ns/record (" << scanned << indexed << (scannedBryan == indexedBryan) << ")";
+}
+
+void benchmarkCsvImport(int rows) {
+    const QString path = QDir::tempPath() + "/one-ages.csv";
+    {
+        QFile file(path);
+        file.open(QIODevice::WriteOnly);
+        QByteArray buffer;
+        buffer.append("name,age\n");
+        for (int i = 0; i < rows; i++) {
+            buffer.append("Person ").append(QByteArray::number(i % 100000)).append(',').append(QByteArray::number(1 + (i * 37) % 120)).append('\n');
+            if (buffer.size() > (1 << 20)) {
+                file.write(buffer);
+                buffer.clear();
+            }
+        }
+        file.write(buffer);
+    }
+    QElapsedTimer timer;
+
+    // The usual way: line by line through QString
+    timer.start();
+    QFile file(path);
+    file.open(QIODevice::ReadOnly);
+    file.readLine();
+    QVector<QString> names;
+    QVector<int> ages;
+    while (!file.atEnd()) {
+        const QStringList fields = QString::fromUtf8(file.readLine()).trimmed().split(',');
+        if (fields.size() != 2) continue;
+        const int age = fields.at(1).toInt();
+        if (age <= 0 || age > 120) continue;
+        names.append(fields.at(0));
+        ages.append(age);
+    }
+    file.close();
+    const qint64 lineMs = timer.restart();
+
+    for (int threads : {1, QThread::idealThreadCount()}) {
+        CsvImporter importer(path);
+        importer.setThreads(threads);
+        importer.setSkipHeader(true);
+        AgeBatch batch;
+        timer.restart();
+        importer.import(batch);
+        const qint64 ms = timer.elapsed();
+        qInfo() << rows << "rows - line by line:" << lineMs << "ms, importer with" << threads << "threads:" << ms << "ms ("
+                << batch.size() << "records," << batch.rejected << "rejected," << ages.size() << ")";
+    }
+    QFile::remove(path);
+}
+
+QByteArray capturedLines;
+
+void capturingHandler(QtMsgType, const QMessageLogContext &, const QString &message) {
+    capturedLines.append(message.toUtf8()).append('\n');
+}
+
+void benchmarkReport(int people) {
+    QObject population;
+    QList<AgeCalc *> calcs;
+    for (int i = 0; i < people; i++) {
+        AgeCalc *calc = new AgeCalc(&population);
+        calc->setName(i % 1000 ? QString("Person %1").arg(i) : QString("Zo\u00EB \"%1\"").arg(i)); // Some need escaping
+        calc->setAge(1 + i % 120);
+        calcs.append(calc);
+    }
+    QElapsedTimer timer;
+
+    capturedLines.clear();
+    QtMessageHandler previous = qInstallMessageHandler(capturingHandler);
+    timer.start();
+    for (AgeCalc *calc : calcs) printAges(*calc);
+    const qint64 serialMs = timer.restart();
+    qInstallMessageHandler(previous);
+
+    const QByteArray report = AgeReport().generate(calcs);
+    const qint64 parallelMs = timer.elapsed();
+
+    qInfo() << people << "people - printAges:" << serialMs << "ms, AgeReport:" << parallelMs << "ms,"
+            << (report == capturedLines ? "identical" : "DIFFERENT") << report.size() << "bytes";
+    capturedLines.clear();
+}
+
+void benchmarkFleet(int laptops) {
+    LaptopFleet fleet;
+    fleet.reserve(laptops);
+    const quint32 brands[] = {fleet.addGroup("Dell"), fleet.addGroup("Lenovo"), fleet.addGroup("Apple"), fleet.addGroup("HP")};
+    for (int i = 0; i < laptops; i++) fleet.add(brands[i % 4], int(2 + (qint64(i) * 7919) % 9));
+
+    FleetSummary reference;
+    for (int threads = 1; threads <= QThread::idealThreadCount(); threads *= 2) {
+        FleetStats stats(threads);
+        stats.setBuckets(1, 12);
+        QElapsedTimer timer;
+        timer.start();
+        const FleetSummary summary = stats.summarize(fleet);
+        const qint64 summaryMs = timer.restart();
+        const QVector<QVector<quint64>> histograms = stats.histograms(fleet);
+        const qint64 histogramMs = timer.elapsed();
+
+        if (threads == 1) reference = summary;
+        const bool same = summary.totalPounds == reference.totalPounds && summary.minPounds == reference.minPounds
+                          && summary.maxPounds == reference.maxPounds;
+        qInfo() << laptops << "laptops," << threads << "threads - summary:" << summaryMs << "ms, histograms:" << histogramMs << "ms,"
+                << "total" << summary.totalKilos() << "kg, mean" << summary.meanKilos() << "kg,"
+                << fleet.groupNames().at(0) << histograms.at(0) << (same ? "deterministic" : "DRIFTED");
+    }
+}
+
+void benchmarkCapabilities(int objects) {
+    QtMessageHandler previous = qInstallMessageHandler(silentHandler);
+    const bool animalsQuiet = Animal::quiet;
+    Animal::quiet = true;
+
+    // Appliances mixed in with things that are not
+    QObject pile;
+    QList<QObject *> mixed;
+    for (int i = 0; i < objects; i++) {
+        switch (i % 3) {
+        case 0: mixed.append(new Appliance(&pile)); break;
+        case 1: mixed.append(new Canine(&pile)); break;
+        default: mixed.append(new AgeCalc(&pile)); break;
+        }
+    }
+    QElapsedTimer timer;
+
+    quint64 rtti = 0;
+    timer.start();
+    for (QObject *object : mixed) {
+        if (Freezer *freezer = dynamic_cast<Freezer *>(object)) rtti += freezer->freeze();
+        if (Microwave *microwave = dynamic_cast<Microwave *>(object)) rtti += microwave->cook();
+    }
+    const qint64 rttiNs = timer.nsecsElapsed();
+
+    quint64 tables = 0;
+    timer.restart();
+    for (QObject *object : mixed) {
+        const ApplianceInterfaces::Table *table = ApplianceInterfaces::table(object);
+        if (!table) continue;
+        if (table->capabilities & ApplianceInterfaces::CanFreeze) tables += table->freezer(object)->freeze();
+        if (table->capabilities & ApplianceInterfaces::CanCook) tables += table->microwave(object)->cook();
+    }
+    const qint64 tableNs = timer.nsecsElapsed();
+
+    Animal::teardown(&pile);
+    Animal::quiet = animalsQuiet;
+    qInstallMessageHandler(previous);
+
+    qInfo() << objects << "objects, ns per object - dynamic_cast:" << double(rttiNs) / objects
+            << "interface table:" << double(tableNs) / objects << "(" << rtti << tables << ")";
+}
+
+void benchmarkApplianceQueue(int operations, int latencyUsecs) {
+    QtMessageHandler previous = qInstallMessageHandler(silentHandler);
+    Appliance machine;
+    qInstallMessageHandler(previous);
+    QElapsedTimer timer;
+
+    // Blocking, one operation after another
+    quint64 syncResults = 0;
+    timer.start();
+    for (int i = 0; i < operations; i++) {
+        syncResults += machine.cook();
+        if (latencyUsecs) QThread::usleep(ulong(latencyUsecs));
+    }
+    const qint64 syncMs = timer.restart();
+
+    ApplianceQueue queue(1024);
+    queue.setSimulatedLatency(latencyUsecs);
+    ApplianceQueue::Completion completions[256];
+    quint64 submitted = 0;
+    quint64 reaped = 0;
+    quint64 tagSum = 0;
+    quint64 asyncResults = 0;
+    QEventLoop loop;
+
+    auto refill = [&] {
+        while (submitted < quint64(operations)
+               && queue.submit(&machine, ApplianceQueue::Operation(submitted % 3), submitted)) submitted++;
+    };
+    QObject::connect(&queue, &ApplianceQueue::completionsReady, &loop, [&] {
+        int count;
+        while ((count = queue.reap(completions, 256)) > 0) {
+            for (int i = 0; i < count; i++) {
+                tagSum += completions[i].tag;
+                asyncResults += completions[i].result;
+            }
+            reaped += quint64(count);
+        }
+        refill();
+        if (reaped == quint64(operations)) loop.quit();
+    });
+
+    timer.restart();
+    refill();
+    if (operations > 0) loop.exec();
+    const qint64 asyncMs = timer.elapsed();
+
+    const quint64 expectedTags = quint64(operations) * quint64(operations - 1) / 2;
+    qInfo() << operations << "operations of" << latencyUsecs << "us - blocking:" << syncMs << "ms, queue:" << asyncMs << "ms"
+            << "(" << syncResults << asyncResults << (tagSum == expectedTags ? "all tags back" : "TAGS MISSING") << ")";
+}
+
+#ifdef Q_OS_LINUX
+class TimerCounter : public QObject
+{
+public:
+    int fired = 0;
+
+protected:
+    void timerEvent(QTimerEvent *) override { fired++; }
+};
+
+qint64 threadCpuNs() {
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return qint64(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+void benchmarkDispatcher(bool epoll, int timers, int msecs) {
+    qint64 registerNs = 0;
+    qint64 dispatchNs = 0;
+    qint64 killNs = 0;
+    quint64 fired = 0;
+
+    QThread *thread = QThread::create([&] {
+        std::unique_ptr<TimerCounter[]> counters(new TimerCounter[timers]);
+        std::vector<int> ids(timers);
+
+        // Intervals spread over 10..999 ms, like a crowd of TestQProperty tickers
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < timers; i++) ids[i] = counters[i].startTimer(10 + (i * 7919) % 990);
+        registerNs = timer.nsecsElapsed();
+
+        QEventLoop loop;
+        QTimer::singleShot(msecs, &loop, &QEventLoop::quit);
+        const qint64 cpu = threadCpuNs();
+        loop.exec();
+        dispatchNs = threadCpuNs() - cpu;
+
+        for (int i = 0; i < timers; i++) fired += counters[i].fired;
+
+        timer.restart();
+        for (int i = 0; i < timers; i++) counters[i].killTimer(ids[i]);
+        killNs = timer.nsecsElapsed();
+    });
+    if (epoll) thread->setEventDispatcher(new EpollDispatcher);
+    thread->start();
+    thread->wait();
+    delete thread;
+
+    qInfo() << (epoll ? "epoll  " : "default") << timers << "timers:"
+            << "register" << registerNs / timers << "ns/timer,"
+            << "dispatch" << (fired ? dispatchNs / qint64(fired) : 0) << "ns/event over" << fired << "events,"
+            << "kill" << killNs / timers << "ns/timer";
+}
+#endif
 
 
 int main(int argc, char *argv[])
 {
+#ifdef Q_OS_LINUX
+    // The main thread's dispatcher has to be chosen before the application exists
+    // QCoreApplication::setEventDispatcher(new EpollDispatcher);
+#endif
     QCoreApplication a(argc, argv);
 
     // Set up code that uses the Qt event loop here.
@@ -404,6 +1407,129 @@ int main(int argc, char *argv[])
     /**/
     /**/
 
+    /*
+    soakBoundedQueue(BoundedQueue::Block, 30);
+    soakBoundedQueue(BoundedQueue::DropNewest, 30);
+    soakBoundedQueue(BoundedQueue::DropOldest, 30);
+    soakBoundedQueue(BoundedQueue::CoalesceByChannel, 30);
+    */
+
+    /*
+    benchmarkJournal(1000000);
+    recoverJournal();
+    */
+
+    /*
+    benchmarkJournal(1000000);
+    replayJournal(JournalReplay::AsFastAsPossible, 1);
+    replayJournal(JournalReplay::Scaled, 10);
+    replayJournal(JournalReplay::OriginalTiming, 1);
+    */
+
+    /*
+    consumerGroups(3);
+    */
+
+    /*
+    shmBenchmark(1000000, 2000);
+    shmBenchmark(1000000, -1);
+    */
+
+    /*
+    benchmarkRadioOff(10000000);
+    */
+
+    /*
+    benchmarkInterest(1000, 1000);
+    */
+
+    /*
+    benchmarkDirectory(100000, 1000000);
+    */
+
+    /*
+    for (int children = 1000; children <= 1000000; children *= 10) benchmarkTeardown(children);
+    */
+
+    /*
+    benchmarkBatching(1000000);
+    */
+
+    /*
+    // Run with stderr redirected to a file
+    benchmarkConsole(1000000);
+    */
+
+    /*
+    benchmarkLogGates(10000000);
+    */
+
+    /*
+    TestQProperty ticker;
+    LoopWatchdog watchdog;
+    watchdog.setStallThreshold(50);
+    watchdog.trackTimer(ticker.timer());
+    watchdog.start();
+    QObject::connect(&watchdog, &LoopWatchdog::stalled, [](qint64 msecs) { qWarning() << "Event loop stalled" << msecs << "ms"; });
+    QTimer::singleShot(3500, [] { QThread::msleep(300); }); // A deliberate stall
+    QTimer::singleShot(10000, &watchdog, &LoopWatchdog::dump);
+    */
+
+#ifdef Q_OS_LINUX
+    /*
+    for (int timers = 1000; timers <= 100000; timers *= 10) {
+        benchmarkDispatcher(false, timers, 5000);
+        benchmarkDispatcher(true, timers, 5000);
+    }
+    */
+#endif
+
+    /*
+    simulateTickers(10000, 3600 * 1000);  // An hour of a big office
+    simulateTickers(1000000, 60 * 1000);  // A minute of a million tickers
+    */
+
+    /*
+    benchmarkZoo(10000000);
+    */
+
+    /*
+    benchmarkTypeChecks(10000000);
+    */
+
+    /*
+    benchmarkSnapshot(1000000);
+    */
+
+    /*
+    benchmarkSpecies(100000000);
+    */
+
+    /*
+    benchmarkAgeIndex(5000000);
+    */
+
+    /*
+    benchmarkCsvImport(50000000);
+    */
+
+    /*
+    benchmarkReport(1000000);
+    */
+
+    /*
+    for (int laptops = 1000000; laptops <= 100000000; laptops *= 10) benchmarkFleet(laptops);
+    */
+
+    /*
+    benchmarkCapabilities(3000000);
+    */
+
+    /*
+    benchmarkApplianceQueue(1000000, 0);
+    benchmarkApplianceQueue(10000, 1000);
+    */
+
     return a.exec();
 }
 
@@ -3,5 +3,6 @@
 Mammal::Mammal(QObject *parent)
     : Animal{parent}
 {
-    qInfo() << this << "Constructed";
+    m_type = MammalType;
+    if (!quiet) qInfo() << this << "Constructed";
 }
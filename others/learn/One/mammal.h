@@ -11,6 +11,9 @@ class Mammal : public Animal
 public:
     explicit Mammal(QObject *parent = nullptr);
 
+    static constexpr quint8 TypeFirst = MammalType;
+    static constexpr quint8 TypeLast = FelineType;
+
     bool hasBackBone() {
         return true;
     }
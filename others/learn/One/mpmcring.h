@@ -0,0 +1,83 @@
+#ifndef MPMCRING_H
+#define MPMCRING_H
+
+#include <QtGlobal>
+#include <atomic>
+#include <memory>
+
+// Bounded lock-free queue for any number of producers and consumers (Vyukov's
+// design): every cell carries a sequence number telling whether it is ready to be
+// written or read on the current lap. All memory is allocated up front, so push
+// and pop never allocate. Capacity is rounded up to a power of two.
+template <typename T>
+class MpmcRing
+{
+public:
+    explicit MpmcRing(int capacity)
+    {
+        size_t size = 2;
+        while (size < size_t(qMax(2, capacity))) size <<= 1;
+        m_cells.reset(new Cell[size]);
+        m_mask = size - 1;
+        for (size_t i = 0; i < size; i++) m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    int capacity() const { return int(m_mask + 1); }
+
+    // False when full
+    bool push(const T &value)
+    {
+        size_t position = m_head.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell &cell = m_cells[position & m_mask];
+            const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            const qptrdiff difference = qptrdiff(sequence) - qptrdiff(position);
+            if (difference == 0) {
+                if (m_head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    cell.value = value;
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = m_head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // False when empty
+    bool pop(T &value)
+    {
+        size_t position = m_tail.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell &cell = m_cells[position & m_mask];
+            const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            const qptrdiff difference = qptrdiff(sequence) - qptrdiff(position + 1);
+            if (difference == 0) {
+                if (m_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    value = cell.value;
+                    cell.sequence.store(position + m_mask + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> m_cells;
+    size_t m_mask = 0;
+    alignas(64) std::atomic<size_t> m_head{0};
+    alignas(64) std::atomic<size_t> m_tail{0};
+};
+
+#endif // MPMCRING_H
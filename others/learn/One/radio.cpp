@@ -1,4 +1,10 @@
 #include "radio.h"
+#include <QChildEvent>
+#include "station.h"
+#include "teardown.h"
+#include "logcategories.h"
+
+std::atomic<quint32> Radio::s_interestEpoch{1};
 
 Radio::Radio(QObject *parent)
     : QObject{parent}
@@ -6,5 +12,110 @@ Radio::Radio(QObject *parent)
 
 void Radio::listen(int channel, QString name, QString message)
 {
-    qInfo() << QString("Channel: %1, Name: %2 - %3").arg(channel).arg(name).arg(message);
+    listenView(channel, name, message);
+}
+
+void Radio::listenBatch(BroadcastSpan messages)
+{
+    for (const Broadcast &item : messages) listenView(item.channel, item.name, item.message);
+}
+
+void Radio::listenView(int channel, QStringView name, QStringView message)
+{
+    if (!isInterested(channel)) return;
+    qCInfoGated(lcRadio) << QString("Channel: %1, Name: %2 - %3").arg(channel).arg(name).arg(message);
+}
+
+void Radio::tune(Station *station)
+{
+    // Already connected by hand, or tuned before: the station keeps what it knows
+    if (connect(station, &Station::send, this, &Radio::listen, Qt::UniqueConnection)) station->addAudience(this);
+}
+
+void Radio::detune(Station *station)
+{
+    disconnect(station, &Station::send, this, &Radio::listen);
+    station->removeAudience(this);
+}
+
+bool Radio::setInterest(const QList<int> &channels)
+{
+    for (int channel : channels) {
+        if (!ChannelSet::isValid(channel)) {
+            qWarning() << "Radio: can not filter on channel" << channel << "- keeping the previous interest";
+            return false;
+        }
+    }
+    m_interest.clear();
+    for (int channel : channels) m_interest.insert(channel);
+    m_filtered.store(true, std::memory_order_relaxed);
+    interestChanged();
+    return true;
+}
+
+void Radio::clearInterest()
+{
+    m_filtered.store(false, std::memory_order_relaxed);
+    m_interest.clear();
+    interestChanged();
+}
+
+void Radio::interestChanged()
+{
+    // Release, so a station that sees the new epoch also sees the new interest
+    if (s_interestEpoch.fetch_add(1, std::memory_order_acq_rel) + 1 == 0) s_interestEpoch.fetch_add(1, std::memory_order_acq_rel);
+}
+
+const ChannelSet &Radio::interest() const
+{
+    return m_interest;
+}
+
+Station *Radio::station(int channel) const
+{
+    return m_stations.byChannel(channel);
+}
+
+Station *Radio::station(const QString &name) const
+{
+    return m_stations.byName(name);
+}
+
+int Radio::stationCount() const
+{
+    return m_stations.size();
+}
+
+bool Radio::event(QEvent *event)
+{
+    // Construction registers through Station's constructor and destruction through its
+    // destructor, since the child is only a plain QObject at those points. These catch
+    // setParent() moving a finished station in or out.
+    if (event->type() == QEvent::ChildAdded || event->type() == QEvent::ChildRemoved) {
+        if (Station *station = qobject_cast<Station *>(static_cast<QChildEvent *>(event)->child())) {
+            if (event->type() == QEvent::ChildAdded) addStation(station);
+            else removeStation(station);
+        }
+    }
+    return QObject::event(event);
+}
+
+void Radio::addStation(Station *station)
+{
+    m_stations.insert(station);
+}
+
+void Radio::removeStation(Station *station)
+{
+    if (!m_tearingDown) m_stations.remove(station);
+}
+
+int Radio::teardown()
+{
+    // Every station is going, so drop the index once rather than per station
+    m_stations.clear();
+    m_tearingDown = true;
+    int deleted = Teardown::children(this);
+    m_tearingDown = false;
+    return deleted;
 }
@@ -3,6 +3,14 @@
 
 #include <QObject>
 #include <QDebug>
+#include <QList>
+#include <QStringView>
+#include <atomic>
+#include "broadcast.h"
+#include "channelset.h"
+#include "stationdirectory.h"
+
+class Station;
 
 class Radio : public QObject
 {
@@ -10,11 +18,58 @@ class Radio : public QObject
 public:
     explicit Radio(QObject *parent = nullptr);
 
+    // Same output as listen() without owning the strings, for replaying mapped journals
+    void listenView(int channel, QStringView name, QStringView message);
+
+    // Connects a station and lets it check our interest before it emits
+    void tune(Station *station);
+    void detune(Station *station);
+
+    // Only these channels get through; clearInterest() goes back to all of them.
+    // A channel ChannelSet can not hold rejects the whole list and keeps the old filter.
+    bool setInterest(const QList<int> &channels);
+    void clearInterest();
+    const ChannelSet &interest() const;
+
+    bool isInterested(int channel) const {
+        return !m_filtered.load(std::memory_order_relaxed) || m_interest.contains(channel);
+    }
+
+    // Bumped by every interest change of any radio, so stations know when what they
+    // cached about their audience is stale. Never 0.
+    static quint32 interestEpoch() {
+        return s_interestEpoch.load(std::memory_order_acquire);
+    }
+
+    // Child stations, kept up to date as they are created, destroyed or re-parented
+    Station *station(int channel) const;
+    Station *station(const QString &name) const;
+    int stationCount() const;
+
+    void addStation(Station *station);
+    void removeStation(Station *station);
+
+    // Deletes every child in linear time; returns how many went
+    int teardown();
+
 signals:
     void quit();
 
 public slots:
     void listen(int channel, QString name, QString message);
+    void listenBatch(BroadcastSpan messages);
+
+protected:
+    bool event(QEvent *event) override;
+
+private:
+    StationDirectory m_stations;
+    bool m_tearingDown = false;
+    ChannelSet m_interest;
+    std::atomic<bool> m_filtered{false};
+
+    static void interestChanged();
+    static std::atomic<quint32> s_interestEpoch;
 };
 
 #endif // RADIO_H
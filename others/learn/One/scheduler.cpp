@@ -0,0 +1,45 @@
+#include "scheduler.h"
+
+Scheduler *Scheduler::real()
+{
+    static RealScheduler scheduler;
+    return &scheduler;
+}
+
+RealScheduler::RealScheduler()
+{
+    m_clock.start();
+}
+
+qint64 RealScheduler::now() const
+{
+    return m_clock.elapsed();
+}
+
+int RealScheduler::start(QObject *context, int msecs, std::function<void()> callback)
+{
+    // Parented to the context, so it dies with it and fires in its thread
+    QTimer *timer = new QTimer(context);
+    QObject::connect(timer, &QTimer::timeout, context, std::move(callback));
+    timer->start(msecs);
+
+    QMutexLocker locker(&m_mutex);
+    const int id = m_nextId++;
+    m_timers.insert(id, timer);
+    QObject::connect(timer, &QObject::destroyed, [this, id] {
+        QMutexLocker locker(&m_mutex);
+        m_timers.remove(id);
+    });
+    return id;
+}
+
+void RealScheduler::stop(int id)
+{
+    QTimer *timer;
+    {
+        QMutexLocker locker(&m_mutex);
+        timer = m_timers.take(id).data();
+    }
+    // Outside the lock: destroyed() takes it again
+    delete timer;
+}
@@ -0,0 +1,47 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QPointer>
+#include <QTimer>
+#include <functional>
+
+// Where timer-driven objects get their clock and their repeating callbacks from.
+// Callbacks stop by themselves once their context object is destroyed.
+// An id means nothing after stop(): a scheduler may hand it out again, the way
+// VirtualScheduler does, so callers forget it once stopped.
+class Scheduler
+{
+public:
+    virtual ~Scheduler() = default;
+
+    virtual qint64 now() const = 0; // Milliseconds
+    virtual int start(QObject *context, int msecs, std::function<void()> callback) = 0;
+    virtual void stop(int id) = 0;
+
+    // Wall-clock scheduler backed by QTimer, shared by everyone who has no other
+    static Scheduler *real();
+};
+
+// Ids only ever grow here. Contexts may live on any thread, so the id table is
+// locked: timers report their own destruction from the context's thread.
+class RealScheduler : public Scheduler
+{
+public:
+    RealScheduler();
+
+    qint64 now() const override;
+    int start(QObject *context, int msecs, std::function<void()> callback) override;
+    void stop(int id) override;
+
+private:
+    QElapsedTimer m_clock;
+    QMutex m_mutex;
+    QHash<int, QPointer<QTimer>> m_timers;
+    int m_nextId = 1;
+};
+
+#endif // SCHEDULER_H
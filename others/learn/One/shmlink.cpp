@@ -0,0 +1,73 @@
+#include "shmlink.h"
+
+ShmSender::ShmSender(ShmRing *ring, QObject *parent)
+    : QObject{parent}, m_ring{ring}
+{}
+
+void ShmSender::setTimeout(int msecs)
+{
+    m_timeout = msecs;
+}
+
+quint64 ShmSender::sent() const
+{
+    return m_sent;
+}
+
+quint64 ShmSender::dropped() const
+{
+    return m_dropped;
+}
+
+void ShmSender::send(int channel, QString name, QString message)
+{
+    if (m_ring->write(channel, name, message, m_timeout)) {
+        m_sent++;
+    } else {
+        m_dropped++;
+    }
+}
+
+ShmReceiver::ShmReceiver(ShmRing *ring, Radio *radio, QObject *parent)
+    : QObject{parent}, m_ring{ring}, m_radio{radio}
+{}
+
+ShmReceiver::~ShmReceiver()
+{
+    stop();
+}
+
+void ShmReceiver::start()
+{
+    if (m_thread) return;
+    m_running = true;
+    m_thread = QThread::create([this] { run(); });
+    m_thread->start();
+}
+
+void ShmReceiver::stop()
+{
+    if (!m_thread) return;
+    m_running = false;
+    m_thread->wait();
+    delete m_thread;
+    m_thread = nullptr;
+}
+
+quint64 ShmReceiver::received() const
+{
+    return m_received.load(std::memory_order_relaxed);
+}
+
+void ShmReceiver::run()
+{
+    while (m_running.load(std::memory_order_relaxed)) {
+        // Wake up now and then to notice stop()
+        if (!m_ring->waitForData(100)) continue;
+
+        int count = m_ring->read([this](const ShmRing::Message &message) {
+            m_radio->listenView(message.channel, message.name, message.message);
+        });
+        m_received.fetch_add(quint64(count), std::memory_order_relaxed);
+    }
+}
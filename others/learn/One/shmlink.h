@@ -0,0 +1,58 @@
+#ifndef SHMLINK_H
+#define SHMLINK_H
+
+#include <QObject>
+#include <QDebug>
+#include <QThread>
+#include <atomic>
+#include "radio.h"
+#include "shmring.h"
+
+// Producer end of a ShmRing: connect Station::send to send() in process A.
+class ShmSender : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ShmSender(ShmRing *ring, QObject *parent = nullptr);
+
+    // How long send() may wait for room before dropping, -1 waits forever
+    void setTimeout(int msecs);
+
+    quint64 sent() const;
+    quint64 dropped() const;
+
+public slots:
+    void send(int channel, QString name, QString message);
+
+private:
+    ShmRing *m_ring;
+    int m_timeout = -1;
+    quint64 m_sent = 0;
+    quint64 m_dropped = 0;
+};
+
+// Consumer end of a ShmRing in process B: a thread that drains the ring into
+// Radio::listenView. The radio is called from that thread.
+class ShmReceiver : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ShmReceiver(ShmRing *ring, Radio *radio, QObject *parent = nullptr);
+    ~ShmReceiver();
+
+    void start();
+    void stop();
+
+    quint64 received() const;
+
+private:
+    void run();
+
+    ShmRing *m_ring;
+    Radio *m_radio;
+    QThread *m_thread = nullptr;
+    std::atomic<bool> m_running{false};
+    std::atomic<quint64> m_received{0};
+};
+
+#endif // SHMLINK_H
@@ -0,0 +1,302 @@
+#include "shmring.h"
+#include <QFile>
+#include <chrono>
+#include <new>
+
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#ifdef Q_OS_LINUX
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+namespace {
+
+constexpr quint32 Magic = 0x474E4952; // "RING"
+constexpr quint32 Version = 1;
+
+static_assert(std::atomic<quint32>::is_always_lock_free && std::atomic<quint64>::is_always_lock_free,
+              "Ring counters are shared between processes and must be lock free");
+
+void futexWait(std::atomic<quint32> &word, quint32 expected, int msecs)
+{
+#ifdef Q_OS_LINUX
+    // Not FUTEX_PRIVATE: the word lives in memory shared with another process
+    timespec timeout{msecs / 1000, (msecs % 1000) * 1000000L};
+    syscall(SYS_futex, reinterpret_cast<quint32 *>(&word), FUTEX_WAIT, expected,
+            msecs < 0 ? nullptr : &timeout, nullptr, 0);
+#elif defined(Q_OS_UNIX)
+    Q_UNUSED(msecs);
+    if (word.load(std::memory_order_acquire) == expected) usleep(50);
+#else
+    Q_UNUSED(msecs);
+    Q_UNUSED(expected);
+#endif
+}
+
+void futexWake(std::atomic<quint32> &word)
+{
+    word.fetch_add(1, std::memory_order_seq_cst);
+#ifdef Q_OS_LINUX
+    syscall(SYS_futex, reinterpret_cast<quint32 *>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#endif
+}
+
+quint64 roundUp(quint64 capacity)
+{
+    quint64 size = 4096;
+    while (size < capacity) size <<= 1;
+    return size;
+}
+
+} // namespace
+
+ShmRing::~ShmRing()
+{
+    close();
+}
+
+bool ShmRing::create(const QString &name, quint64 capacity)
+{
+#ifdef Q_OS_UNIX
+    close();
+    int fd = shm_open(QFile::encodeName(name).constData(), O_CREAT | O_RDWR, 0600);
+    return fd >= 0 && map(fd, true, roundUp(capacity));
+#else
+    Q_UNUSED(name);
+    Q_UNUSED(capacity);
+    return false;
+#endif
+}
+
+bool ShmRing::open(const QString &name)
+{
+#ifdef Q_OS_UNIX
+    close();
+    int fd = shm_open(QFile::encodeName(name).constData(), O_RDWR, 0600);
+    return fd >= 0 && map(fd, false, 0);
+#else
+    Q_UNUSED(name);
+    return false;
+#endif
+}
+
+bool ShmRing::unlink(const QString &name)
+{
+#ifdef Q_OS_UNIX
+    return shm_unlink(QFile::encodeName(name).constData()) == 0;
+#else
+    Q_UNUSED(name);
+    return false;
+#endif
+}
+
+bool ShmRing::createAnonymous(quint64 capacity)
+{
+    close();
+#if defined(Q_OS_LINUX)
+    int fd = memfd_create("queue-tee-ring", 0);
+    return fd >= 0 && map(fd, true, roundUp(capacity));
+#elif defined(Q_OS_UNIX)
+    QByteArray name = "/queue-tee-" + QByteArray::number(qint64(getpid()));
+    int fd = shm_open(name.constData(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) return false;
+    shm_unlink(name.constData());
+    return map(fd, true, roundUp(capacity));
+#else
+    Q_UNUSED(capacity);
+    return false;
+#endif
+}
+
+bool ShmRing::attach(int fd)
+{
+#ifdef Q_OS_UNIX
+    close();
+    int copy = dup(fd);
+    return copy >= 0 && map(copy, false, 0);
+#else
+    Q_UNUSED(fd);
+    return false;
+#endif
+}
+
+int ShmRing::fd() const
+{
+    return m_fd;
+}
+
+bool ShmRing::map(int fd, bool initialize, quint64 capacity)
+{
+#ifdef Q_OS_UNIX
+    m_fd = fd;
+    if (initialize) {
+        if (ftruncate(fd, off_t(sizeof(Control) + capacity)) != 0) {
+            close();
+            return false;
+        }
+    } else {
+        struct stat info;
+        if (fstat(fd, &info) != 0 || quint64(info.st_size) <= sizeof(Control)) {
+            close();
+            return false;
+        }
+        capacity = quint64(info.st_size) - sizeof(Control);
+    }
+
+    m_mapped = sizeof(Control) + capacity;
+    void *base = mmap(nullptr, m_mapped, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        m_mapped = 0;
+        close();
+        return false;
+    }
+
+    m_control = static_cast<Control *>(base);
+    m_data = static_cast<uchar *>(base) + sizeof(Control);
+
+    if (initialize) {
+        new (m_control) Control{};
+        m_control->capacity = capacity;
+        m_control->version = Version;
+        std::atomic_thread_fence(std::memory_order_release);
+        m_control->magic = Magic;
+    } else if (m_control->magic != Magic || m_control->version != Version || m_control->capacity != capacity) {
+        close();
+        return false;
+    }
+
+    m_mask = capacity - 1;
+    return true;
+#else
+    Q_UNUSED(fd);
+    Q_UNUSED(initialize);
+    Q_UNUSED(capacity);
+    return false;
+#endif
+}
+
+void ShmRing::close()
+{
+#ifdef Q_OS_UNIX
+    if (m_control) munmap(m_control, m_mapped);
+    if (m_fd >= 0) ::close(m_fd);
+#endif
+    m_fd = -1;
+    m_control = nullptr;
+    m_data = nullptr;
+    m_mask = 0;
+    m_mapped = 0;
+}
+
+bool ShmRing::isOpen() const
+{
+    return m_control != nullptr;
+}
+
+quint64 ShmRing::capacity() const
+{
+    return m_control ? m_control->capacity : 0;
+}
+
+void ShmRing::setBusyPoll(int spins)
+{
+    m_spins = spins;
+}
+
+bool ShmRing::hasData() const
+{
+    return m_control->head.load(std::memory_order_seq_cst) != m_control->tail.load(std::memory_order_relaxed);
+}
+
+bool ShmRing::hasSpace() const
+{
+    const quint64 head = m_control->head.load(std::memory_order_relaxed);
+    const quint64 contiguous = m_control->capacity - (head & m_mask);
+    const quint64 needed = m_pending <= contiguous ? m_pending : contiguous + m_pending;
+    return head + needed - m_control->tail.load(std::memory_order_seq_cst) <= m_control->capacity;
+}
+
+bool ShmRing::wait(std::atomic<quint32> &signal, std::atomic<quint32> &waiting, int msecs,
+                   bool (ShmRing::*ready)() const)
+{
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(qMax(msecs, 0));
+    const bool forever = m_spins < 0 && msecs != 0;
+    for (qint64 spin = 0; forever || spin < m_spins; spin++) {
+        if ((this->*ready)()) return true;
+        // Spinning without end still honours a timeout; the clock is only read now and then
+        if (forever && msecs > 0 && (spin & 1023) == 1023 && std::chrono::steady_clock::now() >= deadline) {
+            return (this->*ready)();
+        }
+    }
+    if (msecs == 0) return (this->*ready)();
+    while (true) {
+        // Announce before the final check so the other side can not miss us
+        const quint32 seen = signal.load(std::memory_order_seq_cst);
+        waiting.store(1, std::memory_order_seq_cst);
+        if ((this->*ready)()) {
+            waiting.store(0, std::memory_order_relaxed);
+            return true;
+        }
+
+        int left = -1;
+        if (msecs > 0) {
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+            if (remaining.count() <= 0) {
+                waiting.store(0, std::memory_order_relaxed);
+                return false;
+            }
+            left = int(remaining.count());
+        }
+        futexWait(signal, seen, left);
+        waiting.store(0, std::memory_order_relaxed);
+        if ((this->*ready)()) return true;
+    }
+}
+
+bool ShmRing::waitForData(int msecs)
+{
+    return wait(m_control->dataSignal, m_control->consumerWaiting, msecs, &ShmRing::hasData);
+}
+
+void ShmRing::released()
+{
+    if (m_control->producerWaiting.load(std::memory_order_seq_cst)) futexWake(m_control->spaceSignal);
+}
+
+bool ShmRing::write(int channel, QStringView name, QStringView message, int msecs)
+{
+    const quint64 payload = quint64(name.size() + message.size()) * 2;
+    const quint64 size = (sizeof(Header) + payload + 7) & ~quint64(7);
+    if (!m_control || size > m_control->capacity / 2) return false;
+
+    m_pending = size;
+    if (!hasSpace() && !wait(m_control->spaceSignal, m_control->producerWaiting, msecs, &ShmRing::hasSpace)) {
+        return false;
+    }
+
+    quint64 head = m_control->head.load(std::memory_order_relaxed);
+    const quint64 contiguous = m_control->capacity - (head & m_mask);
+    if (size > contiguous) {
+        // Records never wrap; skip to the start and let the reader jump the gap
+        const quint32 padding[2] = {quint32(contiguous), Padding};
+        memcpy(m_data + (head & m_mask), padding, sizeof(padding));
+        head += contiguous;
+    }
+
+    uchar *at = m_data + (head & m_mask);
+    const qint64 timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    Header header{quint32(size), 0, channel, quint32(name.size()), quint32(message.size()), 0, timestamp};
+    memcpy(at, &header, sizeof(header));
+    memcpy(at + sizeof(header), name.data(), size_t(name.size()) * 2);
+    memcpy(at + sizeof(header) + name.size() * 2, message.data(), size_t(message.size()) * 2);
+
+    m_control->head.store(head + size, std::memory_order_seq_cst);
+    if (m_control->consumerWaiting.load(std::memory_order_seq_cst)) futexWake(m_control->dataSignal);
+    return true;
+}
@@ -0,0 +1,123 @@
+#ifndef SHMRING_H
+#define SHMRING_H
+
+#include <QtGlobal>
+#include <QString>
+#include <QStringView>
+#include <atomic>
+#include <climits>
+#include <cstring>
+
+// Single-producer, single-consumer ring of Station broadcasts in a shared memory
+// segment, so a Station in one process can reach a Radio in another. Records are
+// written once, straight into the ring, and read back as views. An idle side can
+// busy-poll or sleep on a futex (plain polling where futexes are not available).
+class ShmRing
+{
+public:
+    struct Message {
+        int channel;
+        qint64 timestamp; // Steady clock nanoseconds when written, comparable across processes
+        QStringView name;
+        QStringView message;
+    };
+
+    ShmRing() = default;
+    ~ShmRing();
+    ShmRing(const ShmRing &) = delete;
+    ShmRing &operator=(const ShmRing &) = delete;
+
+    // Named segment (shm_open) that the other process opens by name
+    bool create(const QString &name, quint64 capacity);
+    bool open(const QString &name);
+    static bool unlink(const QString &name);
+
+    // Unnamed segment (memfd on Linux) shared by fork() or by passing fd() along
+    bool createAnonymous(quint64 capacity);
+    bool attach(int fd);
+    int fd() const;
+
+    void close();
+    bool isOpen() const;
+    quint64 capacity() const;
+
+    // Spins before sleeping when the ring is full or empty; -1 never sleeps, but still
+    // gives up once a wait's msecs have passed
+    void setBusyPoll(int spins);
+
+    // Producer side. Waits up to msecs for room (-1 forever, 0 not at all)
+    bool write(int channel, QStringView name, QStringView message, int msecs = -1);
+
+    // Consumer side. Views passed to visit are only valid inside the call
+    bool waitForData(int msecs = -1);
+    template<typename Visitor>
+    int read(Visitor &&visit, int maxRecords = INT_MAX);
+
+private:
+    struct Header {
+        quint32 size;       // Whole record including padding
+        quint32 flags;
+        qint32 channel;
+        quint32 nameLength;
+        quint32 messageLength;
+        quint32 reserved;
+        qint64 timestamp;
+    };
+    enum Flags { Padding = 1 };
+
+    struct Control {
+        quint32 magic;
+        quint32 version;
+        quint64 capacity;
+        alignas(64) std::atomic<quint64> head;
+        alignas(64) std::atomic<quint64> tail;
+        alignas(64) std::atomic<quint32> dataSignal;
+        std::atomic<quint32> consumerWaiting;
+        alignas(64) std::atomic<quint32> spaceSignal;
+        std::atomic<quint32> producerWaiting;
+    };
+
+    bool map(int fd, bool initialize, quint64 capacity);
+    bool wait(std::atomic<quint32> &signal, std::atomic<quint32> &waiting, int msecs, bool (ShmRing::*ready)() const);
+    bool hasData() const;
+    bool hasSpace() const;
+    void released();
+
+    int m_fd = -1;
+    Control *m_control = nullptr;
+    uchar *m_data = nullptr;
+    quint64 m_mask = 0;
+    size_t m_mapped = 0;
+    quint64 m_pending = 0;
+    int m_spins = 2000;
+};
+
+template<typename Visitor>
+int ShmRing::read(Visitor &&visit, int maxRecords)
+{
+    quint64 tail = m_control->tail.load(std::memory_order_relaxed);
+    const quint64 head = m_control->head.load(std::memory_order_acquire);
+    int count = 0;
+
+    while (tail != head && count < maxRecords) {
+        const uchar *at = m_data + (tail & m_mask);
+        Header header;
+        memcpy(&header, at, 2 * sizeof(quint32));
+        if (!(header.flags & Padding)) {
+            memcpy(&header, at, sizeof(header));
+            const QChar *text = reinterpret_cast<const QChar *>(at + sizeof(Header));
+            visit(Message{header.channel, header.timestamp, QStringView(text, header.nameLength),
+                          QStringView(text + header.nameLength, header.messageLength)});
+            count++;
+        }
+        tail += header.size;
+    }
+
+    if (count > 0 || tail != m_control->tail.load(std::memory_order_relaxed)) {
+        m_control->tail.store(tail, std::memory_order_seq_cst);
+        released();
+    }
+    return count;
+}
+
+#endif // SHMRING_H
@@ -0,0 +1,180 @@
+#include "snapshot.h"
+#include <QDebug>
+#include <cstring>
+#include "mammal.h"
+#include "canine.h"
+#include "feline.h"
+#include "laptop.h"
+#include "agecalc.h"
+#include "station.h"
+#include "crc32c.h"
+
+using namespace SnapshotFormat;
+
+Snapshot::Snapshot(const QString &path, QObject *parent)
+    : QObject{parent}, m_file{path}
+{}
+
+Snapshot::~Snapshot()
+{
+    close();
+}
+
+bool Snapshot::open(bool verify)
+{
+    close();
+
+    if (!m_file.open(QIODevice::ReadOnly) || m_file.size() < qint64(sizeof(Header))) {
+        qWarning() << "Snapshot: can not read" << m_file.fileName() << m_file.errorString();
+        close();
+        return false;
+    }
+
+    const uchar *data = m_file.map(0, m_file.size());
+    if (!data) {
+        qWarning() << "Snapshot: can not map" << m_file.fileName() << m_file.errorString();
+        close();
+        return false;
+    }
+
+    Header header;
+    memcpy(&header, data, sizeof(header));
+    if (header.magic != Magic || header.version != Version || fileSize(header) != m_file.size()) {
+        qWarning() << "Snapshot:" << m_file.fileName() << "is not a version" << Version << "snapshot";
+        close();
+        return false;
+    }
+    if (verify && crc32c(0, data + sizeof(Header), size_t(m_file.size()) - sizeof(Header)) != header.crc) {
+        qWarning() << "Snapshot:" << m_file.fileName() << "is corrupt";
+        close();
+        return false;
+    }
+
+    m_data = data;
+    m_header = header;
+    m_strings = reinterpret_cast<const StringEntry *>(data + tableOffset(header, Strings));
+    m_text = reinterpret_cast<const QChar *>(data + tableOffset(header, TableCount));
+    return true;
+}
+
+void Snapshot::close()
+{
+    m_file.close(); // Also drops the mapping
+    m_data = nullptr;
+    m_header = {};
+    m_strings = nullptr;
+    m_text = nullptr;
+}
+
+bool Snapshot::isOpen() const
+{
+    return m_data != nullptr;
+}
+
+int Snapshot::animalCount() const
+{
+    return int(m_header.counts[Animals]);
+}
+
+int Snapshot::laptopCount() const
+{
+    return int(m_header.counts[Laptops]);
+}
+
+int Snapshot::ageCount() const
+{
+    return int(m_header.counts[Ages]);
+}
+
+int Snapshot::stationCount() const
+{
+    return int(m_header.counts[Stations]);
+}
+
+QStringView Snapshot::string(quint32 index) const
+{
+    if (index >= m_header.counts[Strings]) return QStringView();
+    const StringEntry &entry = m_strings[index];
+    if (quint64(entry.offset) + entry.length > m_header.textLength) return QStringView();
+    return QStringView(m_text + entry.offset, qsizetype(entry.length));
+}
+
+template<typename Record>
+const Record &Snapshot::record(Table table, int index) const
+{
+    Q_ASSERT(index >= 0 && quint32(index) < m_header.counts[table]);
+    return reinterpret_cast<const Record *>(m_data + tableOffset(m_header, table))[index];
+}
+
+Snapshot::AnimalView Snapshot::animal(int index) const
+{
+    const AnimalRecord &record = this->record<AnimalRecord>(Animals, index);
+    const Animal::Type type = record.type < Animal::TypeCount ? Animal::Type(record.type) : Animal::AnimalType;
+    return {string(record.name), type};
+}
+
+Snapshot::LaptopView Snapshot::laptop(int index) const
+{
+    const LaptopRecord &record = this->record<LaptopRecord>(Laptops, index);
+    return {string(record.name), record.weight};
+}
+
+Snapshot::AgeView Snapshot::age(int index) const
+{
+    const AgeRecord &record = this->record<AgeRecord>(Ages, index);
+    return {string(record.name), record.age};
+}
+
+Snapshot::StationView Snapshot::station(int index) const
+{
+    const StationRecord &record = this->record<StationRecord>(Stations, index);
+    return {string(record.name), record.channel};
+}
+
+int Snapshot::materialize(QObject *parent) const
+{
+    if (!isOpen()) return 0;
+
+    // One QString per distinct name, shared by every object that carries it
+    QVector<QString> strings;
+    strings.reserve(int(m_header.counts[Strings]));
+    for (quint32 i = 0; i < m_header.counts[Strings]; i++) strings.append(string(i).toString());
+    auto name = [&strings](quint32 index) { return index < quint32(strings.size()) ? strings.at(int(index)) : QString(); };
+
+    const bool animalsQuiet = Animal::quiet;
+    const bool laptopsQuiet = Laptop::quiet;
+    Animal::quiet = true;
+    Laptop::quiet = true;
+
+    const AnimalRecord *animals = reinterpret_cast<const AnimalRecord *>(m_data + tableOffset(m_header, Animals));
+    for (int i = 0; i < animalCount(); i++) {
+        Animal *animal;
+        switch (animals[i].type) {
+        case Animal::MammalType: animal = new Mammal(parent); break;
+        case Animal::CanineType: animal = new Canine(parent); break;
+        case Animal::FelineType: animal = new Feline(parent); break;
+        default: animal = new Animal(parent); break;
+        }
+        animal->name = name(animals[i].name);
+    }
+
+    const LaptopRecord *laptops = reinterpret_cast<const LaptopRecord *>(m_data + tableOffset(m_header, Laptops));
+    for (int i = 0; i < laptopCount(); i++) {
+        Laptop *laptop = new Laptop(parent, name(laptops[i].name));
+        laptop->weight = laptops[i].weight;
+    }
+
+    const AgeRecord *ages = reinterpret_cast<const AgeRecord *>(m_data + tableOffset(m_header, Ages));
+    for (int i = 0; i < ageCount(); i++) {
+        AgeCalc *calc = new AgeCalc(parent);
+        calc->setName(name(ages[i].name));
+        calc->setAge(ages[i].age);
+    }
+
+    const StationRecord *stations = reinterpret_cast<const StationRecord *>(m_data + tableOffset(m_header, Stations));
+    for (int i = 0; i < stationCount(); i++) new Station(parent, stations[i].channel, name(stations[i].name));
+
+    Animal::quiet = animalsQuiet;
+    Laptop::quiet = laptopsQuiet;
+    return animalCount() + laptopCount() + ageCount() + stationCount();
+}
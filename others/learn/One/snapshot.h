@@ -0,0 +1,58 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <QObject>
+#include <QFile>
+#include <QStringView>
+#include <QVector>
+#include "snapshotformat.h"
+#include "animal.h"
+
+// Read side of a SnapshotWriter file. The file is mapped read-only and checked
+// once. The views hand out names as QStringViews into the mapping, so reading a
+// snapshot allocates nothing. materialize() builds real objects in one go
+// instead: each distinct name becomes one shared QString, and constructors run
+// quietly.
+class Snapshot : public QObject
+{
+    Q_OBJECT
+public:
+    struct AnimalView { QStringView name; Animal::Type type; };
+    struct LaptopView { QStringView name; int weight; };
+    struct AgeView { QStringView name; int age; };
+    struct StationView { QStringView name; int channel; };
+
+    explicit Snapshot(const QString &path, QObject *parent = nullptr);
+    ~Snapshot();
+
+    // Skip the checksum only for files this process has just written itself
+    bool open(bool verify = true);
+    void close();
+    bool isOpen() const;
+
+    int animalCount() const;
+    int laptopCount() const;
+    int ageCount() const;
+    int stationCount() const;
+
+    AnimalView animal(int index) const;
+    LaptopView laptop(int index) const;
+    AgeView age(int index) const;
+    StationView station(int index) const;
+
+    // Creates every object as a child of parent and returns how many were made
+    int materialize(QObject *parent) const;
+
+private:
+    QStringView string(quint32 index) const;
+    template<typename Record>
+    const Record &record(SnapshotFormat::Table table, int index) const;
+
+    QFile m_file;
+    const uchar *m_data = nullptr;
+    SnapshotFormat::Header m_header = {};
+    const SnapshotFormat::StringEntry *m_strings = nullptr;
+    const QChar *m_text = nullptr;
+};
+
+#endif // SNAPSHOT_H
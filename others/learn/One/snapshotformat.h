@@ -0,0 +1,79 @@
+#ifndef SNAPSHOTFORMAT_H
+#define SNAPSHOTFORMAT_H
+
+#include <QtGlobal>
+
+// On-disk layout shared by SnapshotWriter and Snapshot. A file is a Header, then
+// the string table, then one table of fixed 8-byte records per object type, then
+// the UTF-16 text the string table points into. Tables follow each other in
+// TableOrder with no gaps, so offsets follow from the counts alone. Names are
+// interned: every record refers to its string by index.
+namespace SnapshotFormat {
+
+constexpr quint64 Magic = 0x31504E534E454E4FULL; // "ONENSNP1"
+constexpr quint32 Version = 1;
+
+enum Table {
+    Strings,
+    Animals,
+    Laptops,
+    Ages,
+    Stations,
+    TableCount
+};
+
+struct Header {
+    quint64 magic;
+    quint32 version;
+    quint32 crc;                // CRC32C of everything after the header
+    quint32 counts[TableCount];
+    quint32 textLength;         // UTF-16 code units
+    quint64 reserved[3];
+};
+static_assert(sizeof(Header) == 64, "Header must stay 64 bytes");
+
+struct StringEntry {
+    quint32 offset; // Code units into the text
+    quint32 length;
+};
+
+struct AnimalRecord {
+    quint32 name;
+    quint32 type; // Animal::Type
+};
+
+struct LaptopRecord {
+    quint32 name;
+    qint32 weight;
+};
+
+struct AgeRecord {
+    quint32 name;
+    qint32 age;
+};
+
+struct StationRecord {
+    quint32 name;
+    qint32 channel;
+};
+
+static_assert(sizeof(StringEntry) == 8 && sizeof(AnimalRecord) == 8 && sizeof(LaptopRecord) == 8
+              && sizeof(AgeRecord) == 8 && sizeof(StationRecord) == 8, "Records must stay 8 bytes");
+
+constexpr qint64 RecordSize = 8;
+
+inline qint64 tableOffset(const Header &header, int table)
+{
+    qint64 offset = sizeof(Header);
+    for (int i = 0; i < table; i++) offset += qint64(header.counts[i]) * RecordSize;
+    return offset;
+}
+
+inline qint64 fileSize(const Header &header)
+{
+    return tableOffset(header, TableCount) + qint64(header.textLength) * 2;
+}
+
+} // namespace SnapshotFormat
+
+#endif // SNAPSHOTFORMAT_H
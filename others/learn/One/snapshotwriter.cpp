@@ -0,0 +1,101 @@
+#include "snapshotwriter.h"
+#include <QDebug>
+#include <QSaveFile>
+#include "animal.h"
+#include "laptop.h"
+#include "agecalc.h"
+#include "station.h"
+#include "crc32c.h"
+
+using namespace SnapshotFormat;
+
+void SnapshotWriter::add(const Animal *animal)
+{
+    m_animals.append({intern(animal->name), quint32(animal->type())});
+}
+
+void SnapshotWriter::add(const Laptop *laptop)
+{
+    m_laptops.append({intern(laptop->name), qint32(laptop->weight)});
+}
+
+void SnapshotWriter::add(const AgeCalc *calc)
+{
+    m_ages.append({intern(calc->name()), qint32(calc->age())});
+}
+
+void SnapshotWriter::add(const Station *station)
+{
+    m_stations.append({intern(station->name), qint32(station->channel)});
+}
+
+void SnapshotWriter::addChildren(const QObject *root)
+{
+    for (const QObject *child : root->children()) {
+        if (const Animal *animal = qobject_cast<const Animal *>(child)) add(animal);
+        else if (const Laptop *laptop = qobject_cast<const Laptop *>(child)) add(laptop);
+        else if (const AgeCalc *calc = qobject_cast<const AgeCalc *>(child)) add(calc);
+        else if (const Station *station = qobject_cast<const Station *>(child)) add(station);
+        addChildren(child);
+    }
+}
+
+int SnapshotWriter::size() const
+{
+    return m_animals.size() + m_laptops.size() + m_ages.size() + m_stations.size();
+}
+
+void SnapshotWriter::clear()
+{
+    m_index.clear();
+    m_strings.clear();
+    m_text.clear();
+    m_animals.clear();
+    m_laptops.clear();
+    m_ages.clear();
+    m_stations.clear();
+}
+
+quint32 SnapshotWriter::intern(const QString &text)
+{
+    auto it = m_index.constFind(text);
+    if (it != m_index.cend()) return it.value();
+
+    const quint32 index = quint32(m_strings.size());
+    m_strings.append({quint32(m_text.size()), quint32(text.size())});
+    m_text.append(text);
+    m_index.insert(text, index);
+    return index;
+}
+
+bool SnapshotWriter::save(const QString &path) const
+{
+    Header header = {};
+    header.magic = Magic;
+    header.version = Version;
+    header.counts[Strings] = quint32(m_strings.size());
+    header.counts[Animals] = quint32(m_animals.size());
+    header.counts[Laptops] = quint32(m_laptops.size());
+    header.counts[Ages] = quint32(m_ages.size());
+    header.counts[Stations] = quint32(m_stations.size());
+    header.textLength = quint32(m_text.size());
+
+    const QByteArray parts[] = {
+        QByteArray::fromRawData(reinterpret_cast<const char *>(m_strings.constData()), qsizetype(m_strings.size() * RecordSize)),
+        QByteArray::fromRawData(reinterpret_cast<const char *>(m_animals.constData()), qsizetype(m_animals.size() * RecordSize)),
+        QByteArray::fromRawData(reinterpret_cast<const char *>(m_laptops.constData()), qsizetype(m_laptops.size() * RecordSize)),
+        QByteArray::fromRawData(reinterpret_cast<const char *>(m_ages.constData()), qsizetype(m_ages.size() * RecordSize)),
+        QByteArray::fromRawData(reinterpret_cast<const char *>(m_stations.constData()), qsizetype(m_stations.size() * RecordSize)),
+        QByteArray::fromRawData(reinterpret_cast<const char *>(m_text.constData()), qsizetype(m_text.size() * 2)),
+    };
+    for (const QByteArray &part : parts) header.crc = crc32c(header.crc, part.constData(), size_t(part.size()));
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "SnapshotWriter: can not write" << path << file.errorString();
+        return false;
+    }
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    for (const QByteArray &part : parts) file.write(part);
+    return file.commit();
+}
@@ -0,0 +1,45 @@
+#ifndef SNAPSHOTWRITER_H
+#define SNAPSHOTWRITER_H
+
+#include <QObject>
+#include <QHash>
+#include <QVector>
+#include "snapshotformat.h"
+
+class Animal;
+class Laptop;
+class AgeCalc;
+class Station;
+
+// Collects animals, laptops, age calculators and stations into a Snapshot file.
+// Equal names are stored once.
+class SnapshotWriter
+{
+public:
+    void add(const Animal *animal);
+    void add(const Laptop *laptop);
+    void add(const AgeCalc *calc);
+    void add(const Station *station);
+
+    // Adds every supported object below root, depth first
+    void addChildren(const QObject *root);
+
+    int size() const;
+    void clear();
+
+    // Writes to a temporary file and renames it into place
+    bool save(const QString &path) const;
+
+private:
+    quint32 intern(const QString &text);
+
+    QHash<QString, quint32> m_index;
+    QVector<SnapshotFormat::StringEntry> m_strings;
+    QString m_text;
+    QVector<SnapshotFormat::AnimalRecord> m_animals;
+    QVector<SnapshotFormat::LaptopRecord> m_laptops;
+    QVector<SnapshotFormat::AgeRecord> m_ages;
+    QVector<SnapshotFormat::StationRecord> m_stations;
+};
+
+#endif // SNAPSHOTWRITER_H
@@ -0,0 +1,78 @@
+#include "speciesregistry.h"
+#include <QHash>
+#include <QMutex>
+#include <atomic>
+
+namespace {
+
+struct Registry
+{
+    std::atomic<const SpeciesRegistry::Table *> tables[SpeciesRegistry::MaxSpecies] = {};
+    QMutex mutex;
+    QHash<QString, int> ids;
+    QHash<int, QString> names;
+    int next = Animal::TypeCount;
+
+    Registry()
+    {
+        add(Animal::CanineType, "Canine", &SpeciesRegistry::table<Canine>);
+        add(Animal::FelineType, "Feline", &SpeciesRegistry::table<Feline>);
+    }
+
+    void add(int id, const QString &name, const SpeciesRegistry::Table *table)
+    {
+        ids.insert(name, id);
+        names.insert(id, name);
+        tables[id].store(table, std::memory_order_release);
+    }
+};
+
+Registry &registry()
+{
+    static Registry instance;
+    return instance;
+}
+
+} // namespace
+
+int SpeciesRegistry::registerSpecies(const QString &name, int factor)
+{
+    return registerSpecies(name, linear(factor));
+}
+
+int SpeciesRegistry::registerSpecies(const QString &name, const Table &table)
+{
+    Registry &r = registry();
+    QMutexLocker locker(&r.mutex);
+    if (r.ids.contains(name)) return -1;
+    if (r.next >= MaxSpecies) {
+        qWarning("SpeciesRegistry: no room for %s", qPrintable(name));
+        return -1;
+    }
+
+    // Tables live as long as the process, so readers never need the lock
+    const int id = r.next++;
+    r.add(id, name, new Table(table));
+    return id;
+}
+
+int SpeciesRegistry::species(const QString &name)
+{
+    Registry &r = registry();
+    QMutexLocker locker(&r.mutex);
+    return r.ids.value(name, -1);
+}
+
+QString SpeciesRegistry::name(int species)
+{
+    Registry &r = registry();
+    QMutexLocker locker(&r.mutex);
+    return r.names.value(species);
+}
+
+int SpeciesRegistry::years(int species, int age)
+{
+    if (unsigned(species) >= unsigned(MaxSpecies) || !isValidAge(age)) return 0;
+    const Table *table = registry().tables[species].load(std::memory_order_acquire);
+    return table ? (*table)[size_t(age)] : 0;
+}
@@ -0,0 +1,65 @@
+#ifndef SPECIESREGISTRY_H
+#define SPECIESREGISTRY_H
+
+#include <QString>
+#include <array>
+#include "animal.h"
+
+class Canine;
+class Feline;
+
+// Age factors per species as lookup tables over every valid age. Built-in species
+// resolve their table at compile time, so years<Canine>(age) is a bounds check
+// and one load. Other species can be registered at runtime under new ids and are
+// reached through years(species, age); that never touches the built-in path.
+// Invalid ages convert to 0.
+class SpeciesRegistry
+{
+public:
+    static constexpr int MinAge = 1;
+    static constexpr int MaxAge = 120;
+    static constexpr int MaxSpecies = 64;
+
+    using Table = std::array<int, MaxAge + 1>; // Indexed by age, entry 0 unused
+
+    template <typename T>
+    struct Factor; // Specialised for each built-in species
+
+    static constexpr bool isValidAge(int age) {
+        return unsigned(age - MinAge) <= unsigned(MaxAge - MinAge);
+    }
+
+    static constexpr Table linear(int factor) {
+        Table table{};
+        for (int age = MinAge; age <= MaxAge; age++) table[size_t(age)] = age * factor;
+        return table;
+    }
+
+    template <typename T>
+    static constexpr Table table = linear(Factor<T>::value);
+
+    template <typename T>
+    static int years(int age) {
+        return isValidAge(age) ? table<T>[size_t(age)] : 0;
+    }
+
+    // Built-in species use their Animal::Type as id; registered ones come after
+    static int registerSpecies(const QString &name, int factor);
+    static int registerSpecies(const QString &name, const Table &table);
+    static int species(const QString &name); // -1 when unknown
+    static QString name(int species);
+
+    // 0 for unknown species (including plain Animal and Mammal) and invalid ages
+    static int years(int species, int age);
+    static int years(const Animal &animal, int age) {
+        return years(animal.type(), age);
+    }
+};
+
+template <>
+struct SpeciesRegistry::Factor<Canine> { static constexpr int value = 7; };
+
+template <>
+struct SpeciesRegistry::Factor<Feline> { static constexpr int value = 9; };
+
+#endif // SPECIESREGISTRY_H
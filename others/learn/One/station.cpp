@@ -1,12 +1,83 @@
 #include "station.h"
+#include "radio.h"
 
 Station::Station(QObject *parent, int channel, QString name) : QObject{parent}
 {
     this->channel = channel;
     this->name = name;
+
+    if (Radio *radio = qobject_cast<Radio *>(parent)) radio->addStation(this);
+}
+
+Station::~Station()
+{
+    // While a Radio is deleting its children it is already down to a plain QObject,
+    // so the cast fails and we never touch its destroyed directory
+    if (Radio *radio = qobject_cast<Radio *>(parent())) radio->removeStation(this);
 }
 
 void Station::broadcast(QString message)
 {
+    if (!isWanted()) return;
     emit send(channel, name, message);
 }
+
+bool Station::refreshWanted() const
+{
+    QMutexLocker locker(&m_audienceMutex);
+    return updateWanted();
+}
+
+bool Station::updateWanted() const
+{
+    // Epoch first: an interest change landing while we look makes the next call retry
+    const quint32 epoch = Radio::interestEpoch();
+    bool wanted = false;
+    for (const Radio *radio : m_audience) {
+        if (radio->isInterested(channel)) {
+            wanted = true;
+            break;
+        }
+    }
+    m_tuned.store(int(m_audience.size()), std::memory_order_relaxed);
+    m_wanted.store(wanted, std::memory_order_relaxed);
+    m_wantedEpoch.store(epoch, std::memory_order_release);
+    return wanted;
+}
+
+void Station::addAudience(Radio *radio)
+{
+    {
+        QMutexLocker locker(&m_audienceMutex);
+        if (m_audience.contains(radio)) return;
+        m_audience.append(radio);
+        updateWanted();
+    }
+    // Direct, so a radio dying on another thread is gone from the list before it is freed
+    connect(radio, &QObject::destroyed, this, [this, radio] { removeAudience(radio); }, Qt::DirectConnection);
+}
+
+void Station::removeAudience(Radio *radio)
+{
+    bool removed;
+    {
+        QMutexLocker locker(&m_audienceMutex);
+        removed = m_audience.removeOne(radio);
+        if (removed) updateWanted();
+    }
+    if (removed) disconnect(radio, &QObject::destroyed, this, nullptr);
+}
+
+// Both hooks may run with Qt's connection locks held, so they only count and never
+// call back into QObject
+void Station::connectNotify(const QMetaMethod &signal)
+{
+    if (signal == QMetaMethod::fromSignal(&Station::send)) m_receivers.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Station::disconnectNotify(const QMetaMethod &signal)
+{
+    // An invalid signal means everything was disconnected at once
+    if (!signal.isValid()) m_receivers.store(0, std::memory_order_relaxed);
+    else if (signal == QMetaMethod::fromSignal(&Station::send)) m_receivers.fetch_sub(1, std::memory_order_relaxed);
+}
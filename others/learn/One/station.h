@@ -3,19 +3,82 @@
 
 #include <QObject>
 #include <QDebug>
+#include <QList>
+#include <QMetaMethod>
+#include <QMutex>
+#include <atomic>
+
+#include "radio.h"
 
 class Station : public QObject
 {
     Q_OBJECT
 public:
     explicit Station(QObject *parent = nullptr, int channel = 0, QString name = "unknown");
+    ~Station();
 
     QString name;
     int channel;
+
+    // Cached on connect/disconnect, so checking it costs one relaxed load
+    bool isListened() const {
+        return m_receivers.load(std::memory_order_relaxed) > 0;
+    }
+
+    // False when nothing is connected, or everything connected is a tuned radio
+    // that filters out our channel. A few relaxed loads: what the audience wants is
+    // worked out when it changes, not per broadcast.
+    bool isWanted() const {
+        const int connected = m_receivers.load(std::memory_order_relaxed);
+        if (connected == 0) return false;
+        // Receivers connected without Radio::tune() can not tell us what they want
+        if (connected > m_tuned.load(std::memory_order_relaxed)) return true;
+        if (m_wantedEpoch.load(std::memory_order_acquire) != Radio::interestEpoch()) return refreshWanted();
+        return m_wanted.load(std::memory_order_relaxed);
+    }
+
+    // Radios consulted by isWanted(), maintained by Radio::tune()/detune() and by the
+    // radio's destruction. Disconnect a tuned radio with detune(), not disconnect().
+    void addAudience(Radio *radio);
+    void removeAudience(Radio *radio);
+
+    // Only calls produce() for the message when someone wants it
+    template<typename Producer>
+    void broadcastWith(Producer &&produce) {
+        if (!isWanted()) return;
+        emit send(channel, name, produce());
+    }
+
+    // broadcastFormat("Track %1 by %2", track, artist) without formatting while nobody listens
+    template<typename... Args>
+    void broadcastFormat(const char *format, const Args &...args) {
+        if (!isWanted()) return;
+        QString message = QString::fromUtf8(format);
+        ((message = message.arg(args)), ...);
+        emit send(channel, name, message);
+    }
+
 signals:
     void send(int channel, QString name, QString message);
 public slots:
     void broadcast(QString message);
+
+protected:
+    void connectNotify(const QMetaMethod &signal) override;
+    void disconnectNotify(const QMetaMethod &signal) override;
+
+private:
+    bool refreshWanted() const;
+    bool updateWanted() const; // With m_audienceMutex held
+
+    std::atomic<int> m_receivers{0};
+    // Snapshot of m_audience for isWanted(), valid while the epoch matches Radio's
+    mutable std::atomic<int> m_tuned{0};
+    mutable std::atomic<bool> m_wanted{false};
+    mutable std::atomic<quint32> m_wantedEpoch{0};
+    // Changed by tune(), detune() and dying radios on any thread
+    mutable QMutex m_audienceMutex;
+    QList<Radio *> m_audience;
 };
 
 #endif // STATION_H
@@ -0,0 +1,184 @@
+#include "stationdirectory.h"
+#include "station.h"
+
+namespace {
+constexpr int InitialBits = 4;
+}
+
+StationDirectory::StationDirectory()
+{
+    clear();
+}
+
+void StationDirectory::clear()
+{
+    m_slots = QVector<Slot>(1 << InitialBits, Slot{nullptr, 0});
+    m_shift = 32 - InitialBits;
+    m_count = 0;
+    m_nameIds.clear();
+    m_byName.clear();
+    m_channelShadows.clear();
+    m_nameShadows.clear();
+}
+
+quint32 StationDirectory::home(int channel) const
+{
+    // Fibonacci hashing: the top bits of the product are well mixed
+    return (quint32(channel) * 2654435769u) >> m_shift;
+}
+
+int StationDirectory::find(int channel) const
+{
+    const quint32 mask = quint32(m_slots.size() - 1);
+    for (quint32 i = home(channel);; i = (i + 1) & mask) {
+        const Slot &slot = m_slots.at(int(i));
+        if (!slot.station) return -1;
+        if (slot.channel == channel) return int(i);
+    }
+}
+
+// Returns the station that had the channel before, if any
+Station *StationDirectory::place(Station *station, int channel)
+{
+    const quint32 mask = quint32(m_slots.size() - 1);
+    for (quint32 i = home(channel);; i = (i + 1) & mask) {
+        Slot &slot = m_slots[int(i)];
+        if (!slot.station) {
+            slot = Slot{station, channel};
+            m_count++;
+            return nullptr;
+        }
+        if (slot.channel == channel) {
+            Station *previous = slot.station;
+            slot.station = station;
+            return previous;
+        }
+    }
+}
+
+void StationDirectory::grow()
+{
+    QVector<Slot> old = m_slots;
+    m_slots = QVector<Slot>(old.size() * 2, Slot{nullptr, 0});
+    m_shift--;
+    m_count = 0;
+    for (const Slot &slot : old) {
+        if (slot.station) place(slot.station, slot.channel);
+    }
+}
+
+void StationDirectory::insert(Station *station)
+{
+    // Keep the load factor under 3/4 so probe runs stay short
+    if ((m_count + 1) * 4 > m_slots.size() * 3) grow();
+    // Inserted again while hidden: it owns its keys now, so it must not come back twice
+    m_channelShadows.unlink(station->channel, station);
+    Station *hidden = place(station, station->channel);
+    if (hidden && hidden != station) m_channelShadows.push(station->channel, hidden);
+
+    auto it = m_nameIds.constFind(station->name);
+    if (it == m_nameIds.constEnd()) {
+        it = m_nameIds.insert(station->name, m_byName.size());
+        m_byName.append(station);
+    } else {
+        m_nameShadows.unlink(it.value(), station);
+        hidden = m_byName.at(it.value());
+        if (hidden && hidden != station) m_nameShadows.push(it.value(), hidden);
+        m_byName[it.value()] = station;
+    }
+}
+
+void StationDirectory::remove(Station *station)
+{
+    int hole = find(station->channel);
+    if (hole >= 0 && m_slots.at(hole).station == station) {
+        // Shift the rest of the probe run back so lookups never hit a gap
+        const quint32 mask = quint32(m_slots.size() - 1);
+        quint32 i = quint32(hole);
+        for (quint32 j = (i + 1) & mask; m_slots.at(int(j)).station; j = (j + 1) & mask) {
+            const quint32 k = home(m_slots.at(int(j)).channel);
+            const bool stays = i <= j ? (i < k && k <= j) : (i < k || k <= j);
+            if (!stays) {
+                m_slots[int(i)] = m_slots.at(int(j));
+                i = j;
+            }
+        }
+        m_slots[int(i)] = Slot{nullptr, 0};
+        m_count--;
+
+        // The newest station it hid takes the channel back
+        if (Station *previous = m_channelShadows.pop(station->channel)) place(previous, previous->channel);
+    } else {
+        m_channelShadows.unlink(station->channel, station);
+    }
+
+    // Interned ids stay allocated so ids handed out earlier keep their meaning
+    int id = m_nameIds.value(station->name, -1);
+    if (id < 0) return;
+    if (m_byName.at(id) == station) m_byName[id] = m_nameShadows.pop(id);
+    else m_nameShadows.unlink(id, station);
+}
+
+void StationDirectory::Shadows::push(int key, Station *station)
+{
+    Station *newest = m_newest.value(key);
+    m_links.insert(station, Link{newest, nullptr});
+    if (newest) m_links[newest].newer = station;
+    m_newest.insert(key, station);
+}
+
+void StationDirectory::Shadows::unlink(int key, Station *station)
+{
+    auto it = m_links.find(station);
+    if (it == m_links.end()) return;
+    const Link link = it.value();
+    m_links.erase(it);
+
+    if (link.older) m_links[link.older].newer = link.newer;
+    if (link.newer) {
+        m_links[link.newer].older = link.older;
+    } else if (link.older) {
+        m_newest.insert(key, link.older);
+    } else {
+        m_newest.remove(key);
+    }
+}
+
+Station *StationDirectory::Shadows::pop(int key)
+{
+    Station *newest = m_newest.value(key);
+    if (newest) unlink(key, newest);
+    return newest;
+}
+
+void StationDirectory::Shadows::clear()
+{
+    m_newest.clear();
+    m_links.clear();
+}
+
+Station *StationDirectory::byChannel(int channel) const
+{
+    int index = find(channel);
+    return index < 0 ? nullptr : m_slots.at(index).station;
+}
+
+Station *StationDirectory::byName(const QString &name) const
+{
+    return byNameId(nameId(name));
+}
+
+Station *StationDirectory::byNameId(int id) const
+{
+    return id >= 0 && id < m_byName.size() ? m_byName.at(id) : nullptr;
+}
+
+int StationDirectory::nameId(const QString &name) const
+{
+    return m_nameIds.value(name, -1);
+}
+
+int StationDirectory::size() const
+{
+    return m_count;
+}
@@ -0,0 +1,72 @@
+#ifndef STATIONDIRECTORY_H
+#define STATIONDIRECTORY_H
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+class Station;
+
+// Index of a Radio's stations. Channels go through a flat, linearly probed table
+// (deletes shift entries back instead of leaving tombstones); names are interned
+// once so a name lookup is one QHash probe plus an array load. When stations share a
+// channel or name the newest one is found; the ones it hides are kept aside, newest
+// first, and take the key back when it goes. All of that is O(1) per station.
+class StationDirectory
+{
+public:
+    StationDirectory();
+
+    void insert(Station *station);
+    void remove(Station *station);
+    void clear();
+
+    Station *byChannel(int channel) const;
+    Station *byName(const QString &name) const;
+    Station *byNameId(int id) const;
+
+    int nameId(const QString &name) const;
+    int size() const;
+
+private:
+    struct Slot {
+        Station *station;
+        int channel;
+    };
+
+    quint32 home(int channel) const;
+    int find(int channel) const;
+    // Stations hidden behind the owner of a key, as a doubly linked list per key
+    // threaded through a hash, so any of them can be unlinked without a search
+    class Shadows
+    {
+    public:
+        void push(int key, Station *station);
+        void unlink(int key, Station *station);
+        Station *pop(int key);
+        void clear();
+
+    private:
+        struct Link {
+            Station *older;
+            Station *newer;
+        };
+        QHash<int, Station *> m_newest;
+        QHash<Station *, Link> m_links;
+    };
+
+    Station *place(Station *station, int channel);
+    void grow();
+
+    QVector<Slot> m_slots;
+    int m_count = 0;
+    int m_shift = 0;
+
+    QHash<QString, int> m_nameIds;
+    QVector<Station *> m_byName;
+
+    Shadows m_channelShadows; // Keyed by channel
+    Shadows m_nameShadows;    // Keyed by name id
+};
+
+#endif // STATIONDIRECTORY_H
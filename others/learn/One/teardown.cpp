@@ -0,0 +1,24 @@
+#include "teardown.h"
+
+namespace {
+
+void blockSubtree(QObject *object)
+{
+    object->blockSignals(true);
+    for (QObject *child : object->children()) blockSubtree(child);
+}
+
+} // namespace
+
+int Teardown::children(QObject *parent, Mode mode)
+{
+    const QObjectList detached = parent->children();
+    if (mode == Silent) {
+        for (QObject *child : detached) blockSubtree(child);
+    }
+
+    // Always the first child, so QObject finds it at index 0 and removes it there
+    for (QObject *child : detached) child->setParent(nullptr);
+    for (QObject *child : detached) delete child;
+    return int(detached.size());
+}
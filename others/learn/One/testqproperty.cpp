@@ -1,4 +1,5 @@
 #include "testqproperty.h"
+#include "logcategories.h"
 
 TestQProperty::TestQProperty(QObject *parent)
     : QObject{parent}
@@ -9,6 +10,12 @@ TestQProperty::TestQProperty(QObject *parent)
     // m_timer.stop();
 }
 
+TestQProperty::TestQProperty(Scheduler *scheduler, QObject *parent)
+    : QObject{parent}
+{
+    scheduler->start(this, 1000, [this] { timeout(); });
+}
+
 QString TestQProperty::message() const
 {
     return m_message;
@@ -20,7 +27,12 @@ void TestQProperty::setMessage(const QString &newMessage)
     emit messageChanged(m_message);
 }
 
+QTimer *TestQProperty::timer()
+{
+    return &m_timer;
+}
+
 void TestQProperty::timeout()
 {
-    qInfo() << "Test!";
+    qCInfoGated(lcTimer) << "Test!";
 }
@@ -4,6 +4,7 @@
 #include <QObject>
 #include <QDebug>
 #include <QTimer>
+#include "scheduler.h"
 
 class TestQProperty : public QObject
 {
@@ -11,11 +12,14 @@ class TestQProperty : public QObject
     QString m_message;
 public:
     explicit TestQProperty(QObject *parent = nullptr);
+    // Ticks on the given scheduler's clock instead of a wall-clock QTimer
+    explicit TestQProperty(Scheduler *scheduler, QObject *parent = nullptr);
 
     Q_PROPERTY(QString message READ message WRITE setMessage NOTIFY messageChanged FINAL)
 
     QString message() const;
     void setMessage(const QString &newMessage);
+    QTimer *timer();
 
 signals:
     void messageChanged(QString message);
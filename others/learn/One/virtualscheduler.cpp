@@ -0,0 +1,114 @@
+#include "virtualscheduler.h"
+
+VirtualScheduler::VirtualScheduler(qint64 start)
+    : m_now(start)
+{
+}
+
+qint64 VirtualScheduler::now() const
+{
+    return m_now;
+}
+
+int VirtualScheduler::start(QObject *context, int msecs, std::function<void()> callback)
+{
+    int id;
+    if (m_free.empty()) {
+        id = int(m_entries.size());
+        m_entries.push_back({});
+    } else {
+        id = m_free.back();
+        m_free.pop_back();
+    }
+
+    Entry &entry = m_entries[size_t(id)];
+    entry.context = context;
+    entry.callback = std::move(callback);
+    entry.interval = qMax(1, msecs); // A zero interval would never let time move
+    entry.generation++;
+    entry.live = true;
+    m_active++;
+
+    enqueue(id, m_now + entry.interval);
+    return id;
+}
+
+void VirtualScheduler::stop(int id)
+{
+    if (id < 0 || size_t(id) >= m_entries.size() || !m_entries[size_t(id)].live) return;
+
+    // Its bucket entry goes stale and is skipped when that deadline comes round
+    Entry &entry = m_entries[size_t(id)];
+    entry.live = false;
+    entry.context.clear();
+    m_active--;
+    // A callback stopping itself is still running; its slot is freed once it returns
+    if (id != m_firing) {
+        entry.callback = nullptr;
+        m_free.push_back(id);
+    }
+}
+
+void VirtualScheduler::advance(qint64 msecs)
+{
+    advanceTo(m_now + msecs);
+}
+
+void VirtualScheduler::advanceTo(qint64 time)
+{
+    while (!m_due.empty() && m_due.begin()->first <= time) runNext();
+    m_now = qMax(m_now, time);
+}
+
+bool VirtualScheduler::runNext()
+{
+    if (m_due.empty()) return false;
+
+    auto first = m_due.begin();
+    const qint64 deadline = first->first;
+    std::vector<Due> due = std::move(first->second);
+    m_due.erase(first);
+
+    m_now = deadline;
+    fire(deadline, due);
+    return true;
+}
+
+int VirtualScheduler::active() const
+{
+    return m_active;
+}
+
+quint64 VirtualScheduler::fired() const
+{
+    return m_fired;
+}
+
+void VirtualScheduler::enqueue(int id, qint64 deadline)
+{
+    m_due[deadline].push_back({id, m_entries[size_t(id)].generation});
+}
+
+void VirtualScheduler::fire(qint64 deadline, std::vector<Due> &due)
+{
+    for (const Due &item : due) {
+        Entry *entry = &m_entries[size_t(item.id)];
+        if (!entry->live || entry->generation != item.generation) continue;
+        if (entry->context.isNull()) {
+            stop(item.id);
+            continue;
+        }
+
+        m_firing = item.id;
+        entry->callback();
+        m_firing = -1;
+        m_fired++;
+
+        if (entry->live) {
+            enqueue(item.id, deadline + entry->interval);
+        } else {
+            entry->callback = nullptr;
+            m_free.push_back(item.id);
+        }
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef VIRTUALSCHEDULER_H
+#define VIRTUALSCHEDULER_H
+
+#include "scheduler.h"
+#include <deque>
+#include <map>
+#include <vector>
+
+// Simulated clock. Time only moves when advance() is called, and everything that
+// falls due on the way fires immediately, in deadline order. Callbacks due at the
+// same moment fire in the order they were started or last fired. Timers that
+// share a deadline share a bucket, so a million tickers started together cost one
+// ordered-map step per tick plus one call each.
+class VirtualScheduler : public Scheduler
+{
+public:
+    explicit VirtualScheduler(qint64 start = 0);
+
+    qint64 now() const override;
+    int start(QObject *context, int msecs, std::function<void()> callback) override;
+    void stop(int id) override;
+
+    void advance(qint64 msecs);
+    void advanceTo(qint64 time);
+    bool runNext(); // Jumps to the next deadline and fires what is due there
+
+    int active() const;
+    quint64 fired() const;
+
+private:
+    struct Entry
+    {
+        QPointer<QObject> context;
+        std::function<void()> callback;
+        qint64 interval;
+        quint32 generation;
+        bool live;
+    };
+
+    struct Due
+    {
+        int id;
+        quint32 generation;
+    };
+
+    void enqueue(int id, qint64 deadline);
+    void fire(qint64 deadline, std::vector<Due> &due);
+
+    qint64 m_now;
+    std::deque<Entry> m_entries; // Stable addresses while a callback runs
+    std::vector<int> m_free;
+    std::map<qint64, std::vector<Due>> m_due;
+    int m_firing = -1;
+    int m_active = 0;
+    quint64 m_fired = 0;
+};
+
+#endif // VIRTUALSCHEDULER_H
@@ -1,4 +1,5 @@
 #include "watcher.h"
+#include "logcategories.h"
 
 Watcher::Watcher(QObject *parent)
     : QObject{parent}
@@ -6,5 +7,5 @@ Watcher::Watcher(QObject *parent)
 
 void Watcher::messageChanged(QString message)
 {
-    qInfo() << message;
+    qCInfoGated(lcWatcher) << message;
 }
@@ -0,0 +1,12 @@
+#include "zoo.h"
+
+int Zoo::size() const
+{
+    return int(m_canines.size() + m_felines.size());
+}
+
+void Zoo::clear()
+{
+    m_canines.clear();
+    m_felines.clear();
+}
@@ -0,0 +1,78 @@
+#ifndef ZOO_H
+#define ZOO_H
+
+#include <deque>
+#include <type_traits>
+#include "canine.h"
+#include "feline.h"
+
+// Builds one callable out of several lambdas, as for std::visit:
+//     zoo.visit(Overloaded{[](Canine &dog) {...}, [](Feline &cat) {...}});
+template <typename... Ts>
+struct Overloaded : Ts...
+{
+    using Ts::operator()...;
+};
+template <typename... Ts>
+Overloaded(Ts...) -> Overloaded<Ts...>;
+
+// Animals grouped by concrete type. QObjects can't be moved, so each type lives
+// in a deque: chunks of neighbours in memory with addresses that never change.
+// visit() walks one type after another and calls the visitor's overload for the
+// static type, so there are no casts and no virtual calls per animal.
+// The zoo owns its animals; don't give them a parent.
+class Zoo
+{
+public:
+    Zoo() = default;
+    Zoo(const Zoo &) = delete;
+    Zoo &operator=(const Zoo &) = delete;
+
+    template <typename T>
+    T &add()
+    {
+        return storage<T>().emplace_back();
+    }
+
+    template <typename T>
+    int count() const
+    {
+        return int(storage<T>().size());
+    }
+
+    int size() const;
+    void clear();
+
+    template <typename Visitor>
+    void visit(Visitor &&visitor)
+    {
+        for (Canine &canine : m_canines) visitor(canine);
+        for (Feline &feline : m_felines) visitor(feline);
+    }
+
+    template <typename T, typename Function>
+    void each(Function &&function)
+    {
+        for (T &animal : storage<T>()) function(animal);
+    }
+
+private:
+    template <typename T>
+    std::deque<T> &storage()
+    {
+        static_assert(std::is_same_v<T, Canine> || std::is_same_v<T, Feline>, "The zoo keeps canines and felines");
+        if constexpr (std::is_same_v<T, Canine>) return m_canines;
+        else return m_felines;
+    }
+
+    template <typename T>
+    const std::deque<T> &storage() const
+    {
+        return const_cast<Zoo *>(this)->storage<T>();
+    }
+
+    std::deque<Canine> m_canines;
+    std::deque<Feline> m_felines;
+};
+
+#endif // ZOO_H